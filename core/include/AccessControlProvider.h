@@ -24,6 +24,11 @@
 
 #pragma once
 
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonArray>
+#include <QRegularExpression>
+
 #include "AccessControlRule.h"
 #include "NetworkObject.h"
 
@@ -59,7 +64,30 @@ public:
 	bool isAccessToLocalComputerDenied() const;
 
 private:
-	bool isMemberOfUserGroup( const QString& user, const QString& groupName ) const;
+	static constexpr int DecisionCacheTimeToLive = 10000;
+	static constexpr int DecisionCacheMaximumSize = 256;
+
+	struct CompiledRule
+	{
+		AccessControlRule rule;
+		QRegularExpression userGroupRX;
+	};
+
+	struct CachedDecision
+	{
+		Access access;
+		qint64 expiry;
+	};
+
+	// accessing user, accessing computer, local user and sorted list of connected users
+	using DecisionKey = QStringList;
+
+	void compileAccessControlRules();
+	void resetLookupCache() const;
+
+	QStringList groupsOfUser( const QString& user ) const;
+
+	bool isMemberOfUserGroup( const QString& user, const CompiledRule& rule ) const;
 	bool isLocatedAt( const QString& computer, const QString& locationName ) const;
 	bool haveGroupsInCommon( const QString& userOne, const QString& userTwo ) const;
 	bool haveSameLocations( const QString& computerOne, const QString& computerTwo ) const;
@@ -71,16 +99,24 @@ private:
 						   const QString& accessingUser, const QString& accessingComputer,
 						   const QString& localUser, const QString& localComputer ) const;
 
-	bool matchConditions( const AccessControlRule& rule,
+	bool matchConditions( const CompiledRule& compiledRule,
 						  const QString& accessingUser, const QString& accessingComputer,
 						  const QString& localUser, const QString& localComputer,
 						  const QStringList& connectedUsers ) const;
 
 	static QStringList objectNames( const NetworkObjectList& objects );
 
-	QList<AccessControlRule> m_accessControlRules;
+	QJsonArray m_accessControlRulesData;
+	QList<CompiledRule> m_accessControlRules;
 	UserGroupsBackendInterface* m_userGroupsBackend;
 	NetworkObjectDirectory* m_networkObjectDirectory;
 	bool m_queryDomainGroups;
 
+	// results of group and location lookups during a single access control evaluation
+	mutable QHash<QString, QStringList> m_userGroupsCache;
+	mutable QHash<QString, QStringList> m_computerLocationsCache;
+
+	QHash<DecisionKey, CachedDecision> m_decisionCache;
+	QElapsedTimer m_decisionCacheTimer;
+
 } ;
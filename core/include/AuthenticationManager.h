@@ -34,8 +34,21 @@ public:
 	using Plugins = QMap<Plugin::Uid, AuthenticationPluginInterface *>;
 	using Types = QMap<Plugin::Uid, QString>;
 
+	static constexpr int SessionTicketLifetime = 5*60*1000;
+
 	explicit AuthenticationManager( QObject* parent = nullptr );
 
+	// pseudo authentication type used for resuming a previously authenticated
+	// session with a ticket issued by the server
+	static Plugin::Uid sessionTicketUid()
+	{
+		return Plugin::Uid( QStringLiteral("87f5133f-7857-4886-9869-8442186ed6f3") );
+	}
+
+	// secret for proving possession of a session ticket, derived by client and server from a shared
+	// secret agreed on via X25519 key exchange when the ticket is issued so it's never transmitted
+	static QByteArray sessionTicketSecret( const QByteArray& sharedSecret, const QByteArray& sessionTicket );
+
 	const Plugins& plugins() const
 	{
 		return m_plugins;
@@ -42,6 +42,9 @@ public:
 	enum {
 		RsaKeySize = 4096,
 		ChallengeSize = 128,
+		Ed25519KeySize = 32,
+		Ed25519SignatureSize = 64,
+		X25519KeySize = 32,
 	};
 
 	static constexpr auto DefaultEncryptionAlgorithm = QCA::EME_PKCS1_OAEP;
@@ -52,6 +55,22 @@ public:
 
 	static QByteArray generateChallenge();
 
+	// Ed25519 keys are handled via OpenSSL directly as QCA does not support EdDSA -
+	// private keys are passed around as raw seed, public keys as raw key data
+	static SecureArray createEd25519PrivateKey();
+	static QByteArray ed25519PublicKey( const SecureArray& privateKey );
+	static SecureArray ed25519PrivateKeyFromPEM( const QByteArray& pem );
+	static QByteArray ed25519PublicKeyFromPEM( const QByteArray& pem );
+	static QByteArray ed25519PrivateKeyToPEM( const SecureArray& privateKey );
+	static QByteArray ed25519PublicKeyToPEM( const QByteArray& publicKey );
+	static QByteArray signEd25519( const SecureArray& privateKey, const QByteArray& message );
+	static bool verifyEd25519( const QByteArray& publicKey, const QByteArray& message, const QByteArray& signature );
+
+	// ephemeral X25519 keys for agreeing on secrets without transmitting them - same raw key format as above
+	static SecureArray createX25519PrivateKey();
+	static QByteArray x25519PublicKey( const SecureArray& privateKey );
+	static SecureArray deriveX25519SharedSecret( const SecureArray& privateKey, const QByteArray& peerPublicKey );
+
 	QString encryptPassword( const PlaintextPassword& password ) const;
 	PlaintextPassword decryptPassword( const QString& encryptedPassword ) const;
 
@@ -24,11 +24,17 @@
 
 #pragma once
 
+#include <QHash>
 #include <QMutex>
 #include <QPointer>
 #include <QProcess>
+#ifdef Q_OS_LINUX
+#include <QLocalServer>
+#include <QLocalSocket>
+#else
 #include <QTcpServer>
 #include <QTcpSocket>
+#endif
 
 #include "FeatureMessage.h"
 
@@ -45,6 +51,18 @@ public:
 		WorkerProcessModeCount
 	} ;
 
+	enum class InitArgument {
+		WorkerProcessMode
+	};
+
+#ifdef Q_OS_LINUX
+	using Server = QLocalServer;
+	using Socket = QLocalSocket;
+#else
+	using Server = QTcpServer;
+	using Socket = QTcpSocket;
+#endif
+
 	FeatureWorkerManager( VeyonServerInterface& server, FeatureManager& featureManager, QObject* parent = nullptr );
 	~FeatureWorkerManager() override;
 
@@ -56,29 +74,84 @@ public:
 	bool isWorkerRunning( const Feature& feature );
 	FeatureUidList runningWorkers();
 
+#ifdef Q_OS_LINUX
+	static QString serverName();
+	static bool isAuthorizedServer( Socket* socket );
+#endif
+
+	static QString standbyWorkerArgument()
+	{
+		return QStringLiteral("standby");
+	}
+
 private:
 	void acceptConnection();
-	void processConnection( QTcpSocket* socket );
-	void closeConnection( QTcpSocket* socket );
+	void processConnection( Socket* socket );
+	void closeConnection( Socket* socket );
 
-	void sendPendingMessages();
+#ifdef Q_OS_LINUX
+	struct PeerCredentials
+	{
+		qint64 uid{-1};
+		qint64 pid{-1};
+	};
 
-	static constexpr auto UnmanagedSessionProcessRetryInterval = 5000;
+	static constexpr int DefaultUserBufferSize = 16384;
 
-	VeyonServerInterface& m_server;
-	FeatureManager& m_featureManager;
-	QTcpServer m_tcpServer;
+	static bool queryPeerCredentials( Socket* socket, PeerCredentials& credentials );
+	static bool isAuthorizedPeer( const PeerCredentials& credentials );
+#endif
 
 	struct Worker
 	{
-		QPointer<QTcpSocket> socket;
+		QPointer<Socket> socket;
 		QPointer<QProcess> process;
 		QList<FeatureMessage> pendingMessages;
 	};
 
+	struct StartingProcess
+	{
+		int id;
+		QPointer<QProcess> process;
+	};
+
+	struct StandbyWorkerPool
+	{
+		QList<Worker> idleWorkers;
+		QList<StartingProcess> startingProcesses;
+	};
+
+	bool launchWorkerProcess( const QStringList& arguments, WorkerProcessMode workerProcessMode, Worker& worker );
+
+	void startStandbyWorker( WorkerProcessMode workerProcessMode );
+	bool takeStandbyWorker( WorkerProcessMode workerProcessMode, Worker& worker );
+	void addStandbyWorker( Socket* socket, const FeatureMessage& initMessage );
+	void abortStartingStandbyWorker( WorkerProcessMode workerProcessMode, int id );
+	void stopStandbyWorkers();
+
+	Q_INVOKABLE void sendPendingMessages();
+	void sendPendingMessages( Worker& worker );
+
+	static constexpr auto UnmanagedSessionProcessRetryInterval = 5000;
+	static constexpr auto StandbyWorkerPoolSize = 1;
+	static constexpr auto StandbyWorkerStartTimeout = 30000;
+
+	VeyonServerInterface& m_server;
+	FeatureManager& m_featureManager;
+	Server m_ipcServer;
+
 	using WorkerMap = QMap<Feature::Uid, Worker>;
 	WorkerMap m_workers;
 
+	bool m_standbyWorkersEnabled;
+	StandbyWorkerPool m_standbyWorkerPools[WorkerProcessModeCount];
+	int m_lastStandbyWorkerId;
+
 	QMutex m_workersMutex;
 
+#ifdef Q_OS_LINUX
+	// credentials of connected peers as determined when accepting their connections
+	QHash<Socket*, PeerCredentials> m_peerCredentials;
+#endif
+
 } ;
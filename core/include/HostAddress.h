@@ -24,8 +24,13 @@
 
 #pragma once
 
+#include <functional>
+
 #include "VeyonCore.h"
 
+class QHostAddress;
+class QHostInfo;
+
 class VEYON_CORE_EXPORT HostAddress
 {
 	Q_GADGET
@@ -47,13 +52,28 @@ public:
 	}
 
 	bool isLocalHost() const;
+	QList<QHostAddress> addresses() const;
 
 	QString convert( Type targetType ) const;
 	QString tryConvert( Type targetType ) const;
 
+	/*! \brief Performs tryConvert() in a background thread and invokes callback in the thread of context
+	 * once the result is available. The callback is not invoked if context is destroyed before. */
+	void tryConvertAsync( Type targetType, QObject* context, const std::function<void(const QString&)>& callback ) const;
+
 	static QString localFQDN();
+	static QList<QHostAddress> localAddresses();
+
+	static void clearCache();
 
 private:
+	static constexpr int PositiveCacheTimeToLive = 5*60*1000;
+	static constexpr int NegativeCacheTimeToLive = 30*1000;
+	static constexpr int LocalAddressesCacheTimeToLive = 10*1000;
+	static constexpr int MaximumCacheSize = 4096;
+	static constexpr int ResolverThreadCount = 4;
+
+	static QHostInfo lookupHost( const QString& name );
 	static Type determineType( const QString& address );
 	static QString toIpAddress( const QString& hostName );
 	static QString toHostName( Type type, const QString& address );
@@ -24,11 +24,15 @@
 
 #pragma once
 
+#include <QFutureWatcher>
 #include <QHash>
 #include <QObject>
+#include <QPair>
+#include <QSet>
 
 #include "NetworkObject.h"
 
+class QDataStream;
 class QTimer;
 
 class VEYON_CORE_EXPORT NetworkObjectDirectory : public QObject
@@ -42,6 +46,7 @@ public:
 	};
 
 	explicit NetworkObjectDirectory( QObject* parent );
+	~NetworkObjectDirectory() override;
 
 	void setUpdateInterval( int interval );
 
@@ -58,11 +63,23 @@ public:
 	virtual NetworkObjectList queryObjects( NetworkObject::Type type,
 											NetworkObject::Attribute attribute, const QVariant& value );
 	virtual NetworkObjectList queryParents( const NetworkObject& child );
+	virtual QStringList locationsOfHost( const QString& hostAddress );
 
 	virtual void update() = 0;
 	virtual void fetchObjects( const NetworkObject& object );
 
+	void updateInBackground();
+
+	bool loadSnapshot( const QString& fileName );
+	bool saveSnapshot( const QString& fileName ) const;
+
 protected:
+	// creates a new, independent instance of the directory which can be updated in a worker thread -
+	// as it is called from the worker thread, implementations have to call waitForBackgroundUpdate()
+	// in their destructor so the derived instance is not destroyed while being cloned
+	virtual NetworkObjectDirectory* clone() const;
+	void waitForBackgroundUpdate();
+
 	using NetworkObjectFilter = std::function<bool (const NetworkObject &)>;
 
 	bool hasObjects() const;
@@ -71,8 +88,61 @@ protected:
 	void setObjectPopulated( const NetworkObject& networkObject );
 
 private:
+	// parent model ID and object model ID
+	using ObjectKey = QPair<NetworkObject::ModelId, NetworkObject::ModelId>;
+	using ObjectTree = QHash<NetworkObject::ModelId, NetworkObjectList>;
+
+	static constexpr quint32 SnapshotMagic = 0x564e4f44; // "VNOD"
+	static constexpr quint32 SnapshotVersion = 1;
+
+	void writeSnapshotObjects( QDataStream& stream, const NetworkObject& parent ) const;
+	bool readSnapshotObjects( QDataStream& stream, const NetworkObject& parent, ObjectTree& snapshot ) const;
+
+	void finishBackgroundUpdate();
+	void applySnapshot( const ObjectTree& snapshot, const NetworkObject& parent );
+	void addObjects( const NetworkObjectList& objects, const NetworkObject& parent );
+
+	const NetworkObject& objectAt( const ObjectKey& key ) const;
+	void indexObject( const NetworkObject& networkObject, NetworkObject::ModelId parent, int row );
+	void unindexObject( const NetworkObject& networkObject, NetworkObject::ModelId parent );
+	void unindexChildren( NetworkObject::ModelId parent );
+	void updateRows( NetworkObject::ModelId parent, int firstRow );
+	void updateHostLocationIndex();
+
+	static QString attributeIndexKey( const QVariant& value );
+	static QStringList attributeIndexKeys( NetworkObject::Attribute attribute, const QVariant& value );
+	static const QList<NetworkObject::Attribute>& indexedAttributes();
+
+	template<class Key>
+	static void removeFromIndex( QHash<Key, QSet<ObjectKey> >& index, const Key& indexKey, const ObjectKey& objectKey )
+	{
+		const auto it = index.find( indexKey );
+		if( it != index.end() )
+		{
+			it->remove( objectKey );
+			if( it->isEmpty() )
+			{
+				index.erase( it );
+			}
+		}
+	}
+
 	QTimer* m_updateTimer;
-	QHash<NetworkObject::ModelId, NetworkObjectList> m_objects;
+	QFutureWatcher<ObjectTree>* m_updateWatcher;
+	ObjectTree m_objects;
+
+	// secondary indexes which are maintained along with m_objects - keys shared by many objects
+	// (object type, parent UID) map to sets so that removing single objects does not scan all entries
+	QHash<ObjectKey, int> m_objectRows;
+	QMultiHash<NetworkObject::ModelId, NetworkObject::ModelId> m_objectParents;
+	using ObjectKeySet = QSet<ObjectKey>;
+	QHash<int, ObjectKeySet> m_typeIndex;
+	QHash<int, QHash<QString, ObjectKeySet> > m_attributeIndexes;
+
+	// normalized host address -> names of all locations containing the host, rebuilt on demand after changes
+	QHash<QString, QStringList> m_hostLocationIndex;
+	bool m_hostLocationIndexValid;
+
 	NetworkObject m_invalidObject;
 	NetworkObject m_rootObject;
 	NetworkObjectList m_defaultObjectList;
@@ -83,5 +153,6 @@ signals:
 	void objectsAboutToBeRemoved( const NetworkObject& parent, int index, int count );
 	void objectsRemoved();
 	void objectChanged( const NetworkObject& parent, int index );
+	void updated();
 
 };
@@ -24,6 +24,8 @@
 
 #pragma once
 
+#include <QFileInfo>
+#include <QJsonArray>
 #include <QObject>
 
 #include "Plugin.h"
@@ -39,7 +41,7 @@ public:
 	~PluginManager();
 
 	void loadPlatformPlugins();
-	void loadPlugins();
+	void loadPlugins( const QStringList& requiredFeatures = {} );
 	void upgradePlugins();
 
 	const PluginInterfaceList& pluginInterfaces() const
@@ -81,10 +83,21 @@ public:
 private:
 	void initPluginSearchPath();
 	void loadPlugins( const QString& nameFilter );
+	bool loadRequiredPlugins( const QStringList& requiredFeatures );
+	bool loadPlugin( const QFileInfo& fileInfo, QJsonObject* manifestEntry = nullptr );
+
+	QFileInfoList pluginFiles( const QString& nameFilter ) const;
+
+	static QString manifestFilePath();
+	QJsonArray readManifest( const QFileInfoList& plugins ) const;
+	void writeManifest();
+
+	static constexpr auto ManifestFileName = "PluginManifest.json";
 
 	PluginInterfaceList m_pluginInterfaces;
 	QObjectList m_pluginObjects;
 	QList<QPluginLoader *> m_pluginLoaders;
+	QJsonArray m_manifest;
 	bool m_noDebugMessages;
 
 signals:
@@ -69,6 +69,13 @@ public:
 
 	static constexpr auto VeyonConnectionTag = 0xFE14A11;
 
+	struct SessionTicket
+	{
+		QByteArray ticket;
+		QByteArray secret; // used for proving possession of the ticket
+		qint64 expiry{0};
+	};
+
 
 signals:
 	void featureMessageReceived( const FeatureMessage& );
@@ -77,10 +84,15 @@ private:
 	void registerConnection();
 	void unregisterConnection();
 
+	static constexpr int SessionTicketExpiryMargin = 10000;
+
 	// authentication
 	static int8_t handleSecTypeVeyon( rfbClient* client, uint32_t authScheme );
 	static void hookPrepareAuthentication( rfbClient* client );
 
+	static SessionTicket takeSessionTicket( const QString& key );
+	static void storeSessionTicket( const QString& key, const SessionTicket& sessionTicket );
+
 	QPointer<VncConnection> m_vncConnection;
 
 	QString m_user;
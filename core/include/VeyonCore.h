@@ -27,6 +27,7 @@
 #include <QtEndian>
 #include <QVersionNumber>
 #include <QString>
+#include <QStringList>
 #include <QDebug>
 
 #include <atomic>
@@ -88,7 +89,8 @@ public:
 
 	static constexpr char RfbSecurityTypeVeyon = 40;
 
-	VeyonCore( QCoreApplication* application, Component component, const QString& appComponentName );
+	VeyonCore( QCoreApplication* application, Component component, const QString& appComponentName,
+			   const QStringList& requiredFeatures = {} );
 	~VeyonCore() override;
 
 	static VeyonCore* instance();
@@ -194,7 +196,7 @@ private:
 	void initCryptoCore();
 	void initQmlCore();
 	void initAuthenticationCredentials();
-	void initPlugins();
+	void initPlugins( const QStringList& requiredFeatures );
 	void initManagers();
 	void initLocalComputerControlInterface();
 	void initSystemInfo();
@@ -58,7 +58,11 @@ public:
 		m_accessControlState( AccessControlState::Init ),
 		m_username(),
 		m_hostAddress(),
-		m_challenge()
+		m_challenge(),
+		m_sessionTicketsSupported( false ),
+		m_sessionTicketPublicKey(),
+		m_sessionTicketId(),
+		m_sessionTicketExpiry( 0 )
 	{
 	}
 
@@ -147,6 +151,46 @@ public:
 		m_privateKey = privateKey;
 	}
 
+	bool sessionTicketsSupported() const
+	{
+		return m_sessionTicketsSupported;
+	}
+
+	void setSessionTicketsSupported( bool supported )
+	{
+		m_sessionTicketsSupported = supported;
+	}
+
+	const QByteArray& sessionTicketPublicKey() const
+	{
+		return m_sessionTicketPublicKey;
+	}
+
+	void setSessionTicketPublicKey( const QByteArray& publicKey )
+	{
+		m_sessionTicketPublicKey = publicKey;
+	}
+
+	const QByteArray& sessionTicketId() const
+	{
+		return m_sessionTicketId;
+	}
+
+	void setSessionTicketId( const QByteArray& sessionTicketId )
+	{
+		m_sessionTicketId = sessionTicketId;
+	}
+
+	qint64 sessionTicketExpiry() const
+	{
+		return m_sessionTicketExpiry;
+	}
+
+	void setSessionTicketExpiry( qint64 expiry )
+	{
+		m_sessionTicketExpiry = expiry;
+	}
+
 public slots:
 	void finishAccessControl()
 	{
@@ -166,6 +210,10 @@ private:
 	QString m_hostAddress;
 	QByteArray m_challenge;
 	CryptoCore::PrivateKey m_privateKey;
+	bool m_sessionTicketsSupported;
+	QByteArray m_sessionTicketPublicKey;
+	QByteArray m_sessionTicketId;
+	qint64 m_sessionTicketExpiry;
 
 } ;
 
@@ -71,6 +71,15 @@ protected:
 	virtual void processAuthenticationMessage( VariantArrayMessage& message ) = 0;
 	virtual void performAccessControl() = 0;
 
+	// ticket and the server's public key for deriving the secret for proving possession of the ticket
+	using SessionTicket = QPair<QByteArray, QByteArray>;
+
+	// returns ticket which allows the client to skip authentication and access control when reconnecting
+	virtual SessionTicket issueSessionTicket()
+	{
+		return {};
+	}
+
 	QTcpSocket* socket()
 	{
 		return m_socket;
@@ -23,7 +23,6 @@
  */
 
 #include <QNetworkInterface>
-#include <QRegularExpression>
 
 #include "UserGroupsBackendManager.h"
 #include "AccessControlProvider.h"
@@ -37,19 +36,19 @@
 
 
 AccessControlProvider::AccessControlProvider() :
+	m_accessControlRulesData(),
 	m_accessControlRules(),
 	m_userGroupsBackend( VeyonCore::userGroupsBackendManager().accessControlBackend() ),
 	m_networkObjectDirectory( VeyonCore::networkObjectDirectoryManager().configuredDirectory() ),
-	m_queryDomainGroups( VeyonCore::config().domainGroupsForAccessControlEnabled() )
+	m_queryDomainGroups( VeyonCore::config().domainGroupsForAccessControlEnabled() ),
+	m_userGroupsCache(),
+	m_computerLocationsCache(),
+	m_decisionCache(),
+	m_decisionCacheTimer()
 {
-	const QJsonArray accessControlRules = VeyonCore::config().accessControlRules();
+	compileAccessControlRules();
 
-	m_accessControlRules.reserve( accessControlRules.size() );
-
-	for( const auto& accessControlRule : accessControlRules )
-	{
-		m_accessControlRules.append( AccessControlRule( accessControlRule ) );
-	}
+	m_decisionCacheTimer.start();
 }
 
 
@@ -79,39 +78,26 @@ QStringList AccessControlProvider::locations() const
 
 QStringList AccessControlProvider::locationsOfComputer( const QString& computer ) const
 {
-	const auto fqdn = HostAddress( computer ).convert( HostAddress::Type::FullyQualifiedDomainName );
-
-	vDebug() << "Searching for locations of computer" << computer << "via FQDN" << fqdn;
-
-	if( fqdn.isEmpty() )
+	const auto cachedLocations = m_computerLocationsCache.constFind( computer );
+	if( cachedLocations != m_computerLocationsCache.constEnd() )
 	{
-		vWarning() << "Empty FQDN - returning empty location list";
-		return {};
+		return *cachedLocations;
 	}
 
-	const auto computers = m_networkObjectDirectory->queryObjects( NetworkObject::Type::Host,
-																   NetworkObject::Attribute::HostAddress, fqdn );
-	if( computers.isEmpty() )
+	vDebug() << "Searching for locations of computer" << computer;
+
+	// resolved via the directory's host address index instead of querying objects and their parents
+	const auto locationList = m_networkObjectDirectory->locationsOfHost( computer );
+	if( locationList.isEmpty() )
 	{
-		vWarning() << "Could not query any network objects for host" << fqdn;
-		return {};
+		vWarning() << "Could not find any locations for host" << computer;
 	}
-
-	QStringList locationList;
-	locationList.reserve( computers.size()*3 );
-
-	for( const auto& computer : computers )
+	else
 	{
-		const auto parents = m_networkObjectDirectory->queryParents( computer );
-		for( const auto& parent : parents )
-		{
-			locationList.append( parent.name() );
-		}
+		vDebug() << "Found locations:" << locationList;
 	}
 
-	std::sort( locationList.begin(), locationList.end() );
-
-	vDebug() << "Found locations:" << locationList;
+	m_computerLocationsCache[computer] = locationList;
 
 	return locationList;
 }
@@ -122,41 +108,86 @@ AccessControlProvider::Access AccessControlProvider::checkAccess( const QString&
 																  const QString& accessingComputer,
 																  const QStringList& connectedUsers )
 {
+	if( VeyonCore::config().isAccessRestrictedToUserGroups() == false &&
+		VeyonCore::config().isAccessControlRulesProcessingEnabled() == false )
+	{
+		vDebug() << "no access control method configured, allowing access.";
+
+		// no access control method configured, therefore grant access
+		return Access::Allow;
+	}
+
+	// rules might have been changed since this instance has been created
+	compileAccessControlRules();
+
+	const auto localUser = VeyonCore::platform().userFunctions().currentUser();
+
+	auto sortedConnectedUsers = connectedUsers;
+	std::sort( sortedConnectedUsers.begin(), sortedConnectedUsers.end() );
+
+	const auto decisionKey = DecisionKey( { accessingUser, accessingComputer, localUser } ) + sortedConnectedUsers;
+	const auto now = m_decisionCacheTimer.elapsed();
+
+	const auto cachedDecision = m_decisionCache.constFind( decisionKey );
+	if( cachedDecision != m_decisionCache.constEnd() && now < cachedDecision->expiry )
+	{
+		vDebug() << "using cached decision for" << accessingUser << accessingComputer;
+		return cachedDecision->access;
+	}
+
+	auto access = Access::Deny;
+
 	if( VeyonCore::config().isAccessRestrictedToUserGroups() )
 	{
 		if( processAuthorizedGroups( accessingUser ) )
 		{
-			return Access::Allow;
+			access = Access::Allow;
 		}
 	}
-	else if( VeyonCore::config().isAccessControlRulesProcessingEnabled() )
+	else
 	{
-		auto action = processAccessControlRules( accessingUser,
-												 accessingComputer,
-												 VeyonCore::platform().userFunctions().currentUser(),
-												 HostAddress::localFQDN(),
-												 connectedUsers );
-		switch( action )
+		switch( processAccessControlRules( accessingUser,
+										   accessingComputer,
+										   localUser,
+										   HostAddress::localFQDN(),
+										   connectedUsers ) )
 		{
 		case AccessControlRule::Action::Allow:
-			return Access::Allow;
+			access = Access::Allow;
+			break;
 		case AccessControlRule::Action::AskForPermission:
-			return Access::ToBeConfirmed;
+			access = Access::ToBeConfirmed;
+			break;
 		default: break;
 		}
 	}
-	else
+
+	if( access == Access::Deny )
 	{
-		vDebug() << "no access control method configured, allowing access.";
+		vDebug() << "configured access control method did not succeed, denying access.";
+	}
 
-		// no access control method configured, therefore grant access
-		return Access::Allow;
+	if( m_decisionCache.size() >= DecisionCacheMaximumSize )
+	{
+		for( auto it = m_decisionCache.begin(); it != m_decisionCache.end(); )
+		{
+			if( it->expiry <= now )
+			{
+				it = m_decisionCache.erase( it );
+			}
+			else
+			{
+				++it;
+			}
+		}
 	}
 
-	vDebug() << "configured access control method did not succeed, denying access.";
+	if( m_decisionCache.size() < DecisionCacheMaximumSize )
+	{
+		m_decisionCache[decisionKey] = { access, now + DecisionCacheTimeToLive };
+	}
 
-	// configured access control method did not succeed, therefore deny access
-	return Access::Deny;
+	return access;
 }
 
 
@@ -165,7 +196,9 @@ bool AccessControlProvider::processAuthorizedGroups( const QString& accessingUse
 {
 	vDebug() << "processing for user" << accessingUser;
 
-	return m_userGroupsBackend->groupsOfUser( accessingUser, m_queryDomainGroups ).toSet().intersects(
+	resetLookupCache();
+
+	return groupsOfUser( accessingUser ).toSet().intersects(
 				VeyonCore::config().authorizedUserGroups().toSet() );
 }
 
@@ -179,8 +212,12 @@ AccessControlRule::Action AccessControlProvider::processAccessControlRules( cons
 {
 	vDebug() << "processing rules for" << accessingUser << accessingComputer << localUser << localComputer << connectedUsers;
 
-	for( const auto& rule : qAsConst( m_accessControlRules ) )
+	resetLookupCache();
+
+	for( const auto& compiledRule : qAsConst( m_accessControlRules ) )
 	{
+		const auto& rule = compiledRule.rule;
+
 		// rule disabled?
 		if( rule.action() == AccessControlRule::Action::None )
 		{
@@ -189,7 +226,7 @@ AccessControlRule::Action AccessControlProvider::processAccessControlRules( cons
 		}
 
 		if( rule.areConditionsIgnored() ||
-			matchConditions( rule, accessingUser, accessingComputer, localUser, localComputer, connectedUsers ) )
+			matchConditions( compiledRule, accessingUser, accessingComputer, localUser, localComputer, connectedUsers ) )
 		{
 			vDebug() << "rule" << rule.name() << "matched with action" << rule.action();
 			return rule.action();
@@ -212,12 +249,14 @@ bool AccessControlProvider::isAccessToLocalComputerDenied() const
 		return false;
 	}
 
-	for( const auto& rule : qAsConst( m_accessControlRules ) )
+	resetLookupCache();
+
+	for( const auto& compiledRule : qAsConst( m_accessControlRules ) )
 	{
-		if( matchConditions( rule, {}, {},
+		if( matchConditions( compiledRule, {}, {},
 							 VeyonCore::platform().userFunctions().currentUser(), HostAddress::localFQDN(), {} ) )
 		{
-			switch( rule.action() )
+			switch( compiledRule.rule.action() )
 			{
 			case AccessControlRule::Action::Deny:
 				return true;
@@ -235,17 +274,72 @@ bool AccessControlProvider::isAccessToLocalComputerDenied() const
 
 
 
-bool AccessControlProvider::isMemberOfUserGroup( const QString &user,
-												 const QString &groupName ) const
+void AccessControlProvider::compileAccessControlRules()
 {
-	const QRegularExpression groupNameRX( groupName );
+	const auto accessControlRules = VeyonCore::config().accessControlRules();
+	if( accessControlRules == m_accessControlRulesData && m_accessControlRules.size() == accessControlRules.size() )
+	{
+		return;
+	}
 
-	if( groupNameRX.isValid() )
+	m_accessControlRulesData = accessControlRules;
+	m_accessControlRules.clear();
+	m_accessControlRules.reserve( accessControlRules.size() );
+
+	for( const auto& accessControlRule : accessControlRules )
 	{
-		return m_userGroupsBackend->groupsOfUser( user, m_queryDomainGroups ).indexOf( groupNameRX ) >= 0;
+		CompiledRule compiledRule{ AccessControlRule( accessControlRule ), {} };
+
+		const auto groupName = compiledRule.rule.argument( AccessControlRule::Condition::MemberOfUserGroup );
+		if( groupName.isEmpty() == false )
+		{
+			compiledRule.userGroupRX.setPattern( groupName );
+			compiledRule.userGroupRX.optimize();
+		}
+
+		m_accessControlRules.append( compiledRule );
 	}
 
-	return m_userGroupsBackend->groupsOfUser( user, m_queryDomainGroups ).contains( groupName );
+	// previous decisions are based on outdated rules
+	m_decisionCache.clear();
+}
+
+
+
+void AccessControlProvider::resetLookupCache() const
+{
+	m_userGroupsCache.clear();
+	m_computerLocationsCache.clear();
+}
+
+
+
+QStringList AccessControlProvider::groupsOfUser( const QString& user ) const
+{
+	const auto cachedGroups = m_userGroupsCache.constFind( user );
+	if( cachedGroups != m_userGroupsCache.constEnd() )
+	{
+		return *cachedGroups;
+	}
+
+	const auto groups = m_userGroupsBackend->groupsOfUser( user, m_queryDomainGroups );
+	m_userGroupsCache[user] = groups;
+
+	return groups;
+}
+
+
+
+bool AccessControlProvider::isMemberOfUserGroup( const QString& user, const CompiledRule& rule ) const
+{
+	const auto groups = groupsOfUser( user );
+
+	if( rule.userGroupRX.isValid() )
+	{
+		return groups.indexOf( rule.userGroupRX ) >= 0;
+	}
+
+	return groups.contains( rule.rule.argument( AccessControlRule::Condition::MemberOfUserGroup ) );
 }
 
 
@@ -259,8 +353,8 @@ bool AccessControlProvider::isLocatedAt( const QString &computer, const QString
 
 bool AccessControlProvider::haveGroupsInCommon( const QString &userOne, const QString &userTwo ) const
 {
-	const auto userOneGroups = m_userGroupsBackend->groupsOfUser( userOne, m_queryDomainGroups );
-	const auto userTwoGroups = m_userGroupsBackend->groupsOfUser( userTwo, m_queryDomainGroups );
+	const auto userOneGroups = groupsOfUser( userOne );
+	const auto userTwoGroups = groupsOfUser( userTwo );
 
 	return userOneGroups.toSet().intersects( userTwoGroups.toSet() );
 }
@@ -318,11 +412,13 @@ QString AccessControlProvider::lookupSubject( AccessControlRule::Subject subject
 
 
 
-bool AccessControlProvider::matchConditions( const AccessControlRule &rule,
+bool AccessControlProvider::matchConditions( const CompiledRule& compiledRule,
 											 const QString& accessingUser, const QString& accessingComputer,
 											 const QString& localUser, const QString& localComputer,
 											 const QStringList& connectedUsers ) const
 {
+	const auto& rule = compiledRule.rule;
+
 	bool hasConditions = false;
 
 	// normally all selected conditions have to match in order to make the whole rule match
@@ -341,7 +437,7 @@ bool AccessControlProvider::matchConditions( const AccessControlRule &rule,
 		const auto group = rule.argument( condition );
 
 		if( user.isEmpty() || group.isEmpty() ||
-			isMemberOfUserGroup( user, group ) != matchResult )
+			isMemberOfUserGroup( user, compiledRule ) != matchResult )
 		{
 			return false;
 		}
@@ -22,6 +22,8 @@
  *
  */
 
+#include <QMessageAuthenticationCode>
+
 #include "PluginManager.h"
 #include "AuthenticationManager.h"
 #include "VeyonConfiguration.h"
@@ -52,6 +54,13 @@ AuthenticationManager::AuthenticationManager( QObject* parent ) :
 
 
 
+QByteArray AuthenticationManager::sessionTicketSecret( const QByteArray& sharedSecret, const QByteArray& sessionTicket )
+{
+	return QMessageAuthenticationCode::hash( sessionTicket, sharedSecret, QCryptographicHash::Sha256 );
+}
+
+
+
 AuthenticationManager::Types AuthenticationManager::availableTypes() const
 {
 	Types types;
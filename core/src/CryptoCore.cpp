@@ -23,6 +23,9 @@
  */
 
 #include <openssl/bn.h>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/rand.h>
 
 #include "CryptoCore.h"
 
@@ -73,6 +76,348 @@ QByteArray CryptoCore::generateChallenge()
 
 
 
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+// Ed25519 and X25519 keys both consist of 32 bytes of raw key data
+static EVP_PKEY* rawPrivateKeyToEVP( int type, const CryptoCore::SecureArray& privateKey )
+{
+	if( privateKey.size() != CryptoCore::Ed25519KeySize )
+	{
+		return nullptr;
+	}
+
+	return EVP_PKEY_new_raw_private_key( type, nullptr,
+										 reinterpret_cast<const unsigned char *>( privateKey.constData() ),
+										 size_t( privateKey.size() ) );
+}
+
+
+
+static EVP_PKEY* rawPublicKeyToEVP( int type, const QByteArray& publicKey )
+{
+	if( publicKey.size() != CryptoCore::Ed25519KeySize )
+	{
+		return nullptr;
+	}
+
+	return EVP_PKEY_new_raw_public_key( type, nullptr,
+										reinterpret_cast<const unsigned char *>( publicKey.constData() ),
+										size_t( publicKey.size() ) );
+}
+
+
+
+static QByteArray readMemoryBio( BIO* bio )
+{
+	char* data = nullptr;
+	const auto size = BIO_get_mem_data( bio, &data );
+
+	return QByteArray( data, int( size ) );
+}
+#endif
+
+
+
+CryptoCore::SecureArray CryptoCore::createEd25519PrivateKey()
+{
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+	// any random 32 byte seed is a valid Ed25519 private key
+	SecureArray privateKey( Ed25519KeySize );
+	if( RAND_bytes( reinterpret_cast<unsigned char *>( privateKey.data() ), privateKey.size() ) == 1 )
+	{
+		return privateKey;
+	}
+
+	vCritical() << "RAND_bytes() failed";
+#else
+	vCritical() << "Ed25519 keys require OpenSSL 1.1.1 or newer";
+#endif
+
+	return {};
+}
+
+
+
+QByteArray CryptoCore::ed25519PublicKey( const SecureArray& privateKey )
+{
+	QByteArray publicKey;
+
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+	auto key = rawPrivateKeyToEVP( EVP_PKEY_ED25519, privateKey );
+	if( key )
+	{
+		size_t publicKeySize = Ed25519KeySize;
+		publicKey.resize( Ed25519KeySize );
+
+		if( EVP_PKEY_get_raw_public_key( key, reinterpret_cast<unsigned char *>( publicKey.data() ), &publicKeySize ) != 1 )
+		{
+			publicKey.clear();
+		}
+
+		EVP_PKEY_free( key );
+	}
+#else
+	Q_UNUSED(privateKey)
+#endif
+
+	return publicKey;
+}
+
+
+
+CryptoCore::SecureArray CryptoCore::ed25519PrivateKeyFromPEM( const QByteArray& pem )
+{
+	SecureArray privateKey;
+
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+	auto bio = BIO_new_mem_buf( pem.constData(), pem.size() );
+	auto key = PEM_read_bio_PrivateKey( bio, nullptr, nullptr, nullptr );
+
+	if( key && EVP_PKEY_id( key ) == EVP_PKEY_ED25519 )
+	{
+		size_t privateKeySize = Ed25519KeySize;
+		privateKey.resize( Ed25519KeySize );
+
+		if( EVP_PKEY_get_raw_private_key( key, reinterpret_cast<unsigned char *>( privateKey.data() ), &privateKeySize ) != 1 )
+		{
+			privateKey.clear();
+		}
+	}
+
+	EVP_PKEY_free( key );
+	BIO_free( bio );
+#else
+	Q_UNUSED(pem)
+#endif
+
+	return privateKey;
+}
+
+
+
+QByteArray CryptoCore::ed25519PublicKeyFromPEM( const QByteArray& pem )
+{
+	QByteArray publicKey;
+
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+	auto bio = BIO_new_mem_buf( pem.constData(), pem.size() );
+	auto key = PEM_read_bio_PUBKEY( bio, nullptr, nullptr, nullptr );
+
+	if( key && EVP_PKEY_id( key ) == EVP_PKEY_ED25519 )
+	{
+		size_t publicKeySize = Ed25519KeySize;
+		publicKey.resize( Ed25519KeySize );
+
+		if( EVP_PKEY_get_raw_public_key( key, reinterpret_cast<unsigned char *>( publicKey.data() ), &publicKeySize ) != 1 )
+		{
+			publicKey.clear();
+		}
+	}
+
+	EVP_PKEY_free( key );
+	BIO_free( bio );
+#else
+	Q_UNUSED(pem)
+#endif
+
+	return publicKey;
+}
+
+
+
+QByteArray CryptoCore::ed25519PrivateKeyToPEM( const SecureArray& privateKey )
+{
+	QByteArray pem;
+
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+	auto key = rawPrivateKeyToEVP( EVP_PKEY_ED25519, privateKey );
+	auto bio = BIO_new( BIO_s_mem() );
+
+	if( key && PEM_write_bio_PrivateKey( bio, key, nullptr, nullptr, 0, nullptr, nullptr ) == 1 )
+	{
+		pem = readMemoryBio( bio );
+	}
+
+	BIO_free( bio );
+	EVP_PKEY_free( key );
+#else
+	Q_UNUSED(privateKey)
+#endif
+
+	return pem;
+}
+
+
+
+QByteArray CryptoCore::ed25519PublicKeyToPEM( const QByteArray& publicKey )
+{
+	QByteArray pem;
+
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+	auto key = rawPublicKeyToEVP( EVP_PKEY_ED25519, publicKey );
+	auto bio = BIO_new( BIO_s_mem() );
+
+	if( key && PEM_write_bio_PUBKEY( bio, key ) == 1 )
+	{
+		pem = readMemoryBio( bio );
+	}
+
+	BIO_free( bio );
+	EVP_PKEY_free( key );
+#else
+	Q_UNUSED(publicKey)
+#endif
+
+	return pem;
+}
+
+
+
+QByteArray CryptoCore::signEd25519( const SecureArray& privateKey, const QByteArray& message )
+{
+	QByteArray signature;
+
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+	auto key = rawPrivateKeyToEVP( EVP_PKEY_ED25519, privateKey );
+	auto context = EVP_MD_CTX_new();
+
+	if( key && context && EVP_DigestSignInit( context, nullptr, nullptr, nullptr, key ) == 1 )
+	{
+		size_t signatureSize = Ed25519SignatureSize;
+		signature.resize( Ed25519SignatureSize );
+
+		if( EVP_DigestSign( context, reinterpret_cast<unsigned char *>( signature.data() ), &signatureSize,
+							reinterpret_cast<const unsigned char *>( message.constData() ), size_t( message.size() ) ) != 1 )
+		{
+			vCritical() << "EVP_DigestSign() failed";
+			signature.clear();
+		}
+	}
+
+	EVP_MD_CTX_free( context );
+	EVP_PKEY_free( key );
+#else
+	Q_UNUSED(privateKey)
+	Q_UNUSED(message)
+#endif
+
+	return signature;
+}
+
+
+
+bool CryptoCore::verifyEd25519( const QByteArray& publicKey, const QByteArray& message, const QByteArray& signature )
+{
+	bool result = false;
+
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+	auto key = rawPublicKeyToEVP( EVP_PKEY_ED25519, publicKey );
+	auto context = EVP_MD_CTX_new();
+
+	if( key && context && signature.size() == Ed25519SignatureSize &&
+		EVP_DigestVerifyInit( context, nullptr, nullptr, nullptr, key ) == 1 )
+	{
+		result = EVP_DigestVerify( context,
+								   reinterpret_cast<const unsigned char *>( signature.constData() ), size_t( signature.size() ),
+								   reinterpret_cast<const unsigned char *>( message.constData() ), size_t( message.size() ) ) == 1;
+	}
+
+	EVP_MD_CTX_free( context );
+	EVP_PKEY_free( key );
+#else
+	Q_UNUSED(publicKey)
+	Q_UNUSED(message)
+	Q_UNUSED(signature)
+#endif
+
+	return result;
+}
+
+
+
+CryptoCore::SecureArray CryptoCore::createX25519PrivateKey()
+{
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+	// any random 32 byte string is a valid X25519 private key
+	SecureArray privateKey( X25519KeySize );
+	if( RAND_bytes( reinterpret_cast<unsigned char *>( privateKey.data() ), privateKey.size() ) == 1 )
+	{
+		return privateKey;
+	}
+
+	vCritical() << "RAND_bytes() failed";
+#else
+	vCritical() << "X25519 keys require OpenSSL 1.1.1 or newer";
+#endif
+
+	return {};
+}
+
+
+
+QByteArray CryptoCore::x25519PublicKey( const SecureArray& privateKey )
+{
+	QByteArray publicKey;
+
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+	auto key = rawPrivateKeyToEVP( EVP_PKEY_X25519, privateKey );
+	if( key )
+	{
+		size_t publicKeySize = X25519KeySize;
+		publicKey.resize( X25519KeySize );
+
+		if( EVP_PKEY_get_raw_public_key( key, reinterpret_cast<unsigned char *>( publicKey.data() ), &publicKeySize ) != 1 )
+		{
+			publicKey.clear();
+		}
+
+		EVP_PKEY_free( key );
+	}
+#else
+	Q_UNUSED(privateKey)
+#endif
+
+	return publicKey;
+}
+
+
+
+CryptoCore::SecureArray CryptoCore::deriveX25519SharedSecret( const SecureArray& privateKey, const QByteArray& peerPublicKey )
+{
+	SecureArray sharedSecret;
+
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+	auto key = rawPrivateKeyToEVP( EVP_PKEY_X25519, privateKey );
+	auto peerKey = rawPublicKeyToEVP( EVP_PKEY_X25519, peerPublicKey );
+	auto context = key ? EVP_PKEY_CTX_new( key, nullptr ) : nullptr;
+
+	// OpenSSL rejects peer keys resulting in an all-zero shared secret
+	if( peerKey && context &&
+		EVP_PKEY_derive_init( context ) == 1 &&
+		EVP_PKEY_derive_set_peer( context, peerKey ) == 1 )
+	{
+		size_t sharedSecretSize = X25519KeySize;
+		sharedSecret.resize( X25519KeySize );
+
+		if( EVP_PKEY_derive( context, reinterpret_cast<unsigned char *>( sharedSecret.data() ), &sharedSecretSize ) != 1 )
+		{
+			vCritical() << "EVP_PKEY_derive() failed";
+			sharedSecret.clear();
+		}
+	}
+
+	EVP_PKEY_CTX_free( context );
+	EVP_PKEY_free( peerKey );
+	EVP_PKEY_free( key );
+#else
+	Q_UNUSED(privateKey)
+	Q_UNUSED(peerPublicKey)
+#endif
+
+	return sharedSecret;
+}
+
+
+
 QString CryptoCore::encryptPassword( const PlaintextPassword& password ) const
 {
 	return QString::fromLatin1( m_defaultPrivateKey.toPublicKey().
@@ -35,34 +35,61 @@
 #include "PlatformCoreFunctions.h"
 #include "PlatformUserFunctions.h"
 
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <pwd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
 // clazy:excludeall=detaching-member
 
 FeatureWorkerManager::FeatureWorkerManager( VeyonServerInterface& server, FeatureManager& featureManager, QObject* parent ) :
 	QObject( parent ),
 	m_server( server ),
 	m_featureManager( featureManager ),
-	m_tcpServer( this )
+	m_ipcServer( this ),
+	m_standbyWorkersEnabled( VeyonCore::config().standbyWorkersEnabled() ),
+	m_lastStandbyWorkerId( 0 )
 {
-	connect( &m_tcpServer, &QTcpServer::newConnection,
+	connect( &m_ipcServer, &Server::newConnection,
 			 this, &FeatureWorkerManager::acceptConnection );
 
-	if( !m_tcpServer.listen( QHostAddress::LocalHost,
+#ifdef Q_OS_LINUX
+	// workers running as session user have to be able to connect, peers are verified in acceptConnection()
+	m_ipcServer.setSocketOptions( QLocalServer::WorldAccessOption );
+
+	QLocalServer::removeServer( serverName() );
+
+	if( !m_ipcServer.listen( serverName() ) )
+	{
+		vCritical() << "can't listen on local socket" << serverName() << m_ipcServer.errorString();
+	}
+#else
+	if( !m_ipcServer.listen( QHostAddress::LocalHost,
 							 static_cast<quint16>( VeyonCore::config().featureWorkerManagerPort() + VeyonCore::sessionId() ) ) )
 	{
 		vCritical() << "can't listen on localhost!";
 	}
+#endif
 
-	auto pendingMessagesTimer = new QTimer( this );
-	connect( pendingMessagesTimer, &QTimer::timeout, this, &FeatureWorkerManager::sendPendingMessages );
-
-	pendingMessagesTimer->start( 100 );
+	if( m_standbyWorkersEnabled )
+	{
+		QTimer::singleShot( 0, this, [=]() {
+			startStandbyWorker( ManagedSystemProcess );
+			startStandbyWorker( UnmanagedSessionProcess );
+		} );
+	}
 }
 
 
 
 FeatureWorkerManager::~FeatureWorkerManager()
 {
-	m_tcpServer.close();
+	m_ipcServer.close();
+
+	m_standbyWorkersEnabled = false;
+	stopStandbyWorkers();
 
 	// properly shutdown all worker processes
 	while( m_workers.isEmpty() == false )
@@ -93,25 +120,21 @@ void FeatureWorkerManager::startWorker( const Feature& feature, WorkerProcessMod
 
 	Worker worker;
 
-	if( workerProcessMode == ManagedSystemProcess )
+	if( takeStandbyWorker( workerProcessMode, worker ) )
 	{
-		worker.process = new QProcess;
-		worker.process->setProcessChannelMode( QProcess::ForwardedChannels );
+		vDebug() << "Assigning standby worker to feature" << feature.name() << featureUid;
 
-		connect( worker.process, static_cast<void(QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished),
-				 worker.process, &QProcess::deleteLater );
+		// tell standby worker which feature to run - all subsequent messages can be delivered immediately
+		FeatureMessage( feature.uid(), FeatureMessage::InitCommand ).send( worker.socket );
+		worker.socket->flush();
 
-		vDebug() << "Starting worker (managed system process) for feature" << feature.name() << featureUid;
-		worker.process->start( VeyonCore::filesystem().workerFilePath(), { featureUid } );
+		QTimer::singleShot( 0, this, [=]() { startStandbyWorker( workerProcessMode ); } );
 	}
 	else
 	{
-		vDebug() << "Starting worker (unmanaged session process) for feature" << feature.name() << featureUid;
-		const auto ret = VeyonCore::platform().coreFunctions().
-				runProgramAsUser( VeyonCore::filesystem().workerFilePath(), { featureUid },
-								  VeyonCore::platform().userFunctions().currentUser(),
-								  VeyonCore::platform().coreFunctions().activeDesktopName() );
-		if( ret == false )
+		vDebug() << "Starting worker for feature" << feature.name() << featureUid;
+
+		if( launchWorkerProcess( { featureUid }, workerProcessMode, worker ) == false )
 		{
 			vDebug() << "User session likely not yet available - retrying worker start";
 			QTimer::singleShot( UnmanagedSessionProcessRetryInterval, this,
@@ -176,14 +199,33 @@ void FeatureWorkerManager::stopWorker( const Feature &feature )
 
 void FeatureWorkerManager::sendMessage( const FeatureMessage& message )
 {
-	m_workersMutex.lock();
+	QMutexLocker locker( &m_workersMutex );
+
+	const auto it = m_workers.find( message.featureUid() );
+	if( it == m_workers.end() )
+	{
+		return;
+	}
+
+	auto& worker = it.value();
 
-	if( m_workers.contains( message.featureUid() ) )
+	if( worker.socket && thread() == QThread::currentThread() )
 	{
-		m_workers[message.featureUid()].pendingMessages.append( message );
+		// deliver immediately while preserving order of previously queued messages
+		sendPendingMessages( worker );
+		message.send( worker.socket );
+		worker.socket->flush();
 	}
+	else
+	{
+		// queue message until worker has connected or for delivery from our own thread
+		worker.pendingMessages.append( message );
 
-	m_workersMutex.unlock();
+		if( worker.socket )
+		{
+			QMetaObject::invokeMethod( this, "sendPendingMessages", Qt::QueuedConnection );
+		}
+	}
 }
 
 
@@ -213,56 +255,96 @@ FeatureUidList FeatureWorkerManager::runningWorkers()
 
 
 
+#ifdef Q_OS_LINUX
+QString FeatureWorkerManager::serverName()
+{
+	return QStringLiteral("VeyonFeatureWorkerManager-%1").arg( VeyonCore::sessionId() );
+}
+#endif
+
+
+
 void FeatureWorkerManager::acceptConnection()
 {
 	vDebug() << "accepting connection";
 
-	QTcpSocket* socket = m_tcpServer.nextPendingConnection();
+	auto socket = m_ipcServer.nextPendingConnection();
+
+#ifdef Q_OS_LINUX
+	PeerCredentials credentials;
+	if( queryPeerCredentials( socket, credentials ) == false || isAuthorizedPeer( credentials ) == false )
+	{
+		vCritical() << "rejecting connection from unauthorized peer";
+		socket->abort();
+		socket->deleteLater();
+		return;
+	}
+
+	m_peerCredentials[socket] = credentials;
+	connect( socket, &QObject::destroyed, this, [=]() { m_peerCredentials.remove( socket ); } );
+#endif
 
 	// connect to readyRead() signal of new connection
-	connect( socket, &QTcpSocket::readyRead,
+	connect( socket, &Socket::readyRead,
 			 this, [=] () { processConnection( socket ); } );
 
-	connect( socket, &QTcpSocket::disconnected,
+	connect( socket, &Socket::disconnected,
 			 this, [=] () { closeConnection( socket ); } );
 }
 
 
 
-void FeatureWorkerManager::processConnection( QTcpSocket* socket )
+void FeatureWorkerManager::processConnection( Socket* socket )
 {
 	FeatureMessage message;
-	message.receive( socket );
-
-	m_workersMutex.lock();
 
-	// set socket information
-	if( m_workers.contains( message.featureUid() ) )
+	// process all complete messages which have been received so far
+	while( message.isReadyForReceive( socket ) )
 	{
-		if( m_workers[message.featureUid()].socket.isNull() )
+		if( message.receive( socket ) == false )
 		{
-			m_workers[message.featureUid()].socket = socket;
+			break;
 		}
 
-		m_workersMutex.unlock();
+		m_workersMutex.lock();
 
-		if( message.command() >= 0 )
+		// set socket information
+		const auto it = m_workers.find( message.featureUid() );
+		if( message.featureUid().isNull() && message.command() == FeatureMessage::InitCommand )
 		{
-			m_featureManager.handleFeatureMessage( m_server, MessageContext( socket ), message );
+			m_workersMutex.unlock();
+
+			addStandbyWorker( socket, message );
 		}
+		else if( it != m_workers.end() )
+		{
+			if( it->socket.isNull() )
+			{
+				it->socket = socket;
 
-	}
-	else
-	{
-		m_workersMutex.unlock();
+				// worker is connected now so deliver all messages queued in the meantime
+				sendPendingMessages( it.value() );
+			}
+
+			m_workersMutex.unlock();
+
+			if( message.command() >= 0 )
+			{
+				m_featureManager.handleFeatureMessage( m_server, MessageContext( socket ), message );
+			}
+		}
+		else
+		{
+			m_workersMutex.unlock();
 
-		vCritical() << "got data from non-existing worker!" << message.featureUid();
+			vCritical() << "got data from non-existing worker!" << message.featureUid();
+		}
 	}
 }
 
 
 
-void FeatureWorkerManager::closeConnection( QTcpSocket* socket )
+void FeatureWorkerManager::closeConnection( Socket* socket )
 {
 	m_workersMutex.lock();
 
@@ -281,25 +363,322 @@ void FeatureWorkerManager::closeConnection( QTcpSocket* socket )
 
 	m_workersMutex.unlock();
 
+	for( int mode = 0; mode < WorkerProcessModeCount; ++mode )
+	{
+		auto& idleWorkers = m_standbyWorkerPools[mode].idleWorkers;
+
+		for( auto it = idleWorkers.begin(); it != idleWorkers.end(); )
+		{
+			if( it->socket == socket )
+			{
+				vDebug() << "removing standby worker after socket has been closed";
+				it = idleWorkers.erase( it );
+
+				QTimer::singleShot( UnmanagedSessionProcessRetryInterval, this, [=]() {
+					startStandbyWorker( static_cast<WorkerProcessMode>( mode ) );
+				} );
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+
 	socket->deleteLater();
 }
 
 
 
-void FeatureWorkerManager::sendPendingMessages()
+#ifdef Q_OS_LINUX
+bool FeatureWorkerManager::queryPeerCredentials( Socket* socket, PeerCredentials& credentials )
 {
-	m_workersMutex.lock();
+	struct ucred peerCredentials{};
+	socklen_t credentialsLength = sizeof(peerCredentials);
 
-	for( auto it = m_workers.begin(); it != m_workers.end(); ++it )
+	if( getsockopt( static_cast<int>( socket->socketDescriptor() ), SOL_SOCKET, SO_PEERCRED,
+					&peerCredentials, &credentialsLength ) != 0 )
+	{
+		vWarning() << "could not query peer credentials";
+		return false;
+	}
+
+	credentials.uid = peerCredentials.uid;
+	credentials.pid = peerCredentials.pid;
+
+	return true;
+}
+
+
+
+bool FeatureWorkerManager::isAuthorizedPeer( const PeerCredentials& credentials )
+{
+	// managed system workers run with our own credentials
+	if( credentials.uid == getuid() )
+	{
+		return true;
+	}
+
+	// unmanaged session workers run as the user logged on to the session
+	const auto user = VeyonCore::platform().userFunctions().currentUser().toUtf8();
+	if( user.isEmpty() )
 	{
-		auto& worker = it.value();
+		return false;
+	}
+
+	// use reentrant variant as connections may be accepted while other threads look up users
+	const auto bufferSizeHint = sysconf( _SC_GETPW_R_SIZE_MAX );
+	QByteArray buffer( bufferSizeHint > 0 ? int( bufferSizeHint ) : DefaultUserBufferSize, 0 );
+	struct passwd userEntry{};
+	struct passwd* result = nullptr;
+
+	int error = 0;
+	while( ( error = getpwnam_r( user.constData(), &userEntry, buffer.data(), size_t( buffer.size() ), &result ) ) == ERANGE )
+	{
+		buffer.resize( buffer.size() * 2 );
+	}
+
+	return error == 0 && result && userEntry.pw_uid == credentials.uid;
+}
+
+
+
+/*!
+ * \brief Verifies that the given worker socket is connected to the server
+ *
+ * The socket lives in a world-writable directory so workers, especially the ones running as root,
+ * must not trust whatever process listens on it but only the server which runs either as root
+ * (launched by the service) or with the same credentials as the worker.
+ */
+bool FeatureWorkerManager::isAuthorizedServer( Socket* socket )
+{
+	PeerCredentials credentials;
+	if( queryPeerCredentials( socket, credentials ) == false )
+	{
+		return false;
+	}
+
+	return credentials.uid == 0 || credentials.uid == getuid();
+}
+#endif
+
+
+
+bool FeatureWorkerManager::launchWorkerProcess( const QStringList& arguments, WorkerProcessMode workerProcessMode,
+												Worker& worker )
+{
+	if( workerProcessMode == ManagedSystemProcess )
+	{
+		worker.process = new QProcess;
+		worker.process->setProcessChannelMode( QProcess::ForwardedChannels );
+
+		connect( worker.process, static_cast<void(QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished),
+				 worker.process, &QProcess::deleteLater );
+
+		vDebug() << "Starting managed system process" << arguments;
+		worker.process->start( VeyonCore::filesystem().workerFilePath(), arguments );
+
+		return true;
+	}
+
+	vDebug() << "Starting unmanaged session process" << arguments;
 
-		while( worker.socket && worker.pendingMessages.isEmpty() == false )
+	return VeyonCore::platform().coreFunctions().
+			runProgramAsUser( VeyonCore::filesystem().workerFilePath(), arguments,
+							  VeyonCore::platform().userFunctions().currentUser(),
+							  VeyonCore::platform().coreFunctions().activeDesktopName() );
+}
+
+
+
+void FeatureWorkerManager::startStandbyWorker( WorkerProcessMode workerProcessMode )
+{
+	auto& pool = m_standbyWorkerPools[workerProcessMode];
+
+	if( m_standbyWorkersEnabled == false ||
+		pool.idleWorkers.count() + pool.startingProcesses.count() >= StandbyWorkerPoolSize )
+	{
+		return;
+	}
+
+	Worker worker;
+
+	if( launchWorkerProcess( { standbyWorkerArgument(), QString::number( workerProcessMode ) },
+							 workerProcessMode, worker ) == false )
+	{
+		QTimer::singleShot( UnmanagedSessionProcessRetryInterval, this,
+							[=]() { startStandbyWorker( workerProcessMode ); } );
+		return;
+	}
+
+	// unmanaged session processes are tracked through a null process pointer
+	const auto id = ++m_lastStandbyWorkerId;
+	pool.startingProcesses.append( { id, worker.process } );
+
+	// free the pool slot again if the process exits or does not connect in time
+	if( worker.process )
+	{
+		connect( worker.process, static_cast<void(QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished),
+				 this, [=]() { abortStartingStandbyWorker( workerProcessMode, id ); } );
+	}
+
+	QTimer::singleShot( StandbyWorkerStartTimeout, this, [=]() { abortStartingStandbyWorker( workerProcessMode, id ); } );
+}
+
+
+
+bool FeatureWorkerManager::takeStandbyWorker( WorkerProcessMode workerProcessMode, Worker& worker )
+{
+	auto& idleWorkers = m_standbyWorkerPools[workerProcessMode].idleWorkers;
+
+	while( idleWorkers.isEmpty() == false )
+	{
+		worker = idleWorkers.takeFirst();
+		if( worker.socket && worker.socket->isOpen() )
 		{
-			worker.pendingMessages.first().send( worker.socket );
-			worker.pendingMessages.removeFirst();
+			return true;
 		}
 	}
 
-	m_workersMutex.unlock();
+	worker = {};
+
+	return false;
+}
+
+
+
+void FeatureWorkerManager::addStandbyWorker( Socket* socket, const FeatureMessage& initMessage )
+{
+	const auto workerProcessMode = initMessage.argument( InitArgument::WorkerProcessMode ).toInt();
+
+	if( workerProcessMode < 0 || workerProcessMode >= WorkerProcessModeCount ||
+		m_standbyWorkerPools[workerProcessMode].startingProcesses.isEmpty() )
+	{
+		vCritical() << "got init message from unexpected standby worker";
+		socket->abort();
+		return;
+	}
+
+	auto& pool = m_standbyWorkerPools[workerProcessMode];
+
+#ifdef Q_OS_LINUX
+	// session users are allowed to connect as well so make sure they can't pose as a managed system worker
+	// and receive messages for system features (e.g. screen lock) or the credentials of the demo server
+	int processIndex = -1;
+
+	if( workerProcessMode == ManagedSystemProcess )
+	{
+		const auto credentials = m_peerCredentials.value( socket );
+
+		for( int i = 0; i < pool.startingProcesses.count(); ++i )
+		{
+			const auto& process = pool.startingProcesses[i].process;
+			if( credentials.uid == getuid() && process && process->processId() == credentials.pid )
+			{
+				processIndex = i;
+				break;
+			}
+		}
+	}
+	else
+	{
+		processIndex = 0;
+	}
+
+	if( processIndex < 0 )
+	{
+		vCritical() << "got init message from standby worker which has not been launched by us";
+		socket->abort();
+		return;
+	}
+
+	Worker worker;
+	worker.socket = socket;
+	worker.process = pool.startingProcesses.takeAt( processIndex ).process;
+#else
+	Worker worker;
+	worker.socket = socket;
+	worker.process = pool.startingProcesses.takeFirst().process;
+#endif
+
+	vDebug() << "standby worker ready for process mode" << workerProcessMode;
+
+	pool.idleWorkers.append( worker );
+}
+
+
+
+void FeatureWorkerManager::abortStartingStandbyWorker( WorkerProcessMode workerProcessMode, int id )
+{
+	auto& startingProcesses = m_standbyWorkerPools[workerProcessMode].startingProcesses;
+
+	for( auto it = startingProcesses.begin(); it != startingProcesses.end(); ++it )
+	{
+		if( it->id == id )
+		{
+			vWarning() << "standby worker for process mode" << workerProcessMode << "exited or did not connect in time";
+
+			if( it->process && it->process->state() != QProcess::NotRunning )
+			{
+				it->process->kill();
+			}
+
+			startingProcesses.erase( it );
+
+			QTimer::singleShot( UnmanagedSessionProcessRetryInterval, this,
+								[=]() { startStandbyWorker( workerProcessMode ); } );
+			return;
+		}
+	}
+}
+
+
+
+void FeatureWorkerManager::stopStandbyWorkers()
+{
+	for( auto& pool : m_standbyWorkerPools )
+	{
+		for( const auto& worker : qAsConst( pool.idleWorkers ) )
+		{
+			if( worker.socket )
+			{
+				worker.socket->disconnect( this );
+				worker.socket->close();
+				worker.socket->deleteLater();
+			}
+		}
+
+		pool.idleWorkers.clear();
+		pool.startingProcesses.clear();
+	}
+}
+
+
+
+void FeatureWorkerManager::sendPendingMessages()
+{
+	QMutexLocker locker( &m_workersMutex );
+
+	for( auto it = m_workers.begin(); it != m_workers.end(); ++it )
+	{
+		sendPendingMessages( it.value() );
+	}
+}
+
+
+
+void FeatureWorkerManager::sendPendingMessages( Worker& worker )
+{
+	if( worker.socket.isNull() || worker.pendingMessages.isEmpty() )
+	{
+		return;
+	}
+
+	for( const auto& message : qAsConst( worker.pendingMessages ) )
+	{
+		message.send( worker.socket );
+	}
+
+	worker.pendingMessages.clear();
+	worker.socket->flush();
 }
@@ -22,12 +22,36 @@
  *
  */
 
+#include <QDateTime>
+#include <QFutureWatcher>
 #include <QHostInfo>
+#include <QMutex>
 #include <QNetworkInterface>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include <QtConcurrent>
 
 #include "HostAddress.h"
 
 
+struct HostInfoCacheEntry
+{
+	QHostInfo hostInfo;
+	qint64 expiry;
+};
+
+static QMutex __hostInfoCacheMutex;
+static QWaitCondition __hostInfoLookupFinished;
+static QHash<QString, HostInfoCacheEntry> __hostInfoCache;
+static QSet<QString> __pendingHostInfoLookups;
+
+static QList<QHostAddress> __localAddresses;
+static qint64 __localAddressesExpiry = 0;
+
+static QString __localFQDN;
+static qint64 __localFQDNExpiry = 0;
+
+
 HostAddress::HostAddress( const QString& address ) :
 	m_type( determineType( address ) ),
 	m_address( address )
@@ -43,16 +67,10 @@ bool HostAddress::isLocalHost() const
 		return false;
 	}
 
-	const auto allLocalAddresses = QNetworkInterface::allAddresses();
+	const auto allLocalAddresses = localAddresses();
 
-	if( type() == Type::IpAddress )
-	{
-		QHostAddress hostAddress( m_address );
-		return hostAddress.isLoopback() || allLocalAddresses.contains( hostAddress );
-	}
-
-	const auto addresses = QHostInfo::fromName( m_address ).addresses();
-	for( const auto& address : addresses )
+	const auto hostAddresses = addresses();
+	for( const auto& address : hostAddresses )
 	{
 		if( address.isLoopback() || allLocalAddresses.contains( address ) )
 		{
@@ -65,6 +83,26 @@ bool HostAddress::isLocalHost() const
 
 
 
+QList<QHostAddress> HostAddress::addresses() const
+{
+	switch( type() )
+	{
+	case Type::Invalid:
+		return {};
+
+	case Type::IpAddress:
+		return { QHostAddress( m_address ) };
+
+	case Type::HostName:
+	case Type::FullyQualifiedDomainName:
+		break;
+	}
+
+	return lookupHost( m_address ).addresses();
+}
+
+
+
 QString HostAddress::convert( HostAddress::Type targetType ) const
 {
 	if( m_type == targetType )
@@ -99,26 +137,168 @@ QString HostAddress::tryConvert( HostAddress::Type targetType ) const
 
 
 
+void HostAddress::tryConvertAsync( Type targetType, QObject* context,
+								   const std::function<void(const QString&)>& callback ) const
+{
+	// use a separate thread pool so slow DNS servers can't starve the global thread pool
+	static const auto resolverThreadPool = []() {
+		auto threadPool = new QThreadPool;
+		threadPool->setMaxThreadCount( ResolverThreadCount );
+		return threadPool;
+	}();
+
+	const auto hostAddress = *this;
+
+	auto watcher = new QFutureWatcher<QString>( context );
+	QObject::connect( watcher, &QFutureWatcher<QString>::finished, context, [=]() {
+		callback( watcher->result() );
+		watcher->deleteLater();
+	} );
+
+	watcher->setFuture( QtConcurrent::run( resolverThreadPool, [=]() {
+		return hostAddress.tryConvert( targetType );
+	} ) );
+}
+
+
+
 QString HostAddress::localFQDN()
 {
+	const auto now = QDateTime::currentMSecsSinceEpoch();
+
+	QMutexLocker locker( &__hostInfoCacheMutex );
+	if( now < __localFQDNExpiry )
+	{
+		return __localFQDN;
+	}
+	locker.unlock();
+
 	const auto localHostName = QHostInfo::localHostName();
-	const auto type = determineType( localHostName );
+	QString fqdn;
 
-	switch( type )
+	switch( determineType( localHostName ) )
 	{
 	case Type::HostName:
-		return localHostName + QStringLiteral( "." ) + QHostInfo::localDomainName();
+		fqdn = localHostName + QStringLiteral( "." ) + QHostInfo::localDomainName();
+		break;
 
 	case Type::FullyQualifiedDomainName:
-		return localHostName;
+		fqdn = localHostName;
+		break;
 
 	default:
+		vWarning() << "Could not determine local host name:" << localHostName;
+		fqdn = HostAddress( localHostName ).convert( Type::FullyQualifiedDomainName );
 		break;
 	}
 
-	vWarning() << "Could not determine local host name:" << localHostName;
+	locker.relock();
+	__localFQDN = fqdn;
+	__localFQDNExpiry = now + ( fqdn.isEmpty() ? NegativeCacheTimeToLive : PositiveCacheTimeToLive );
+
+	return fqdn;
+}
+
+
+
+QList<QHostAddress> HostAddress::localAddresses()
+{
+	const auto now = QDateTime::currentMSecsSinceEpoch();
+
+	QMutexLocker locker( &__hostInfoCacheMutex );
+	if( now < __localAddressesExpiry )
+	{
+		return __localAddresses;
+	}
+	locker.unlock();
+
+	// interfaces and their addresses can change at any time (e.g. DHCP, VPN, WiFi roaming) so
+	// re-read them periodically instead of once per process
+	const auto allAddresses = QNetworkInterface::allAddresses();
+
+	locker.relock();
+	__localAddresses = allAddresses;
+	__localAddressesExpiry = now + LocalAddressesCacheTimeToLive;
+
+	return allAddresses;
+}
+
+
+
+void HostAddress::clearCache()
+{
+	QMutexLocker locker( &__hostInfoCacheMutex );
+
+	__hostInfoCache.clear();
+	__localAddresses.clear();
+	__localAddressesExpiry = 0;
+	__localFQDN.clear();
+	__localFQDNExpiry = 0;
+}
+
+
+
+QHostInfo HostAddress::lookupHost( const QString& name )
+{
+	const auto key = name.toLower();
+
+	QMutexLocker locker( &__hostInfoCacheMutex );
+
+	forever
+	{
+		const auto it = __hostInfoCache.constFind( key );
+		if( it != __hostInfoCache.constEnd() && QDateTime::currentMSecsSinceEpoch() < it->expiry )
+		{
+			return it->hostInfo;
+		}
+
+		if( __pendingHostInfoLookups.contains( key ) == false )
+		{
+			break;
+		}
+
+		// another thread already resolves the same name so wait for its result instead of
+		// querying the DNS server once more
+		__hostInfoLookupFinished.wait( &__hostInfoCacheMutex );
+	}
+
+	__pendingHostInfoLookups.insert( key );
+	locker.unlock();
+
+	const auto hostInfo = QHostInfo::fromName( name );
+	const auto successful = hostInfo.error() == QHostInfo::NoError && hostInfo.addresses().isEmpty() == false;
+
+	locker.relock();
+
+	__pendingHostInfoLookups.remove( key );
+
+	const auto now = QDateTime::currentMSecsSinceEpoch();
+
+	if( __hostInfoCache.size() >= MaximumCacheSize )
+	{
+		for( auto it = __hostInfoCache.begin(); it != __hostInfoCache.end(); )
+		{
+			if( it->expiry <= now )
+			{
+				it = __hostInfoCache.erase( it );
+			}
+			else
+			{
+				++it;
+			}
+		}
+
+		if( __hostInfoCache.size() >= MaximumCacheSize )
+		{
+			__hostInfoCache.clear();
+		}
+	}
+
+	__hostInfoCache[key] = { hostInfo, now + ( successful ? PositiveCacheTimeToLive : NegativeCacheTimeToLive ) };
+
+	__hostInfoLookupFinished.wakeAll();
 
-	return HostAddress( localHostName ).convert( Type::FullyQualifiedDomainName );
+	return hostInfo;
 }
 
 
@@ -157,7 +337,7 @@ QString HostAddress::toIpAddress( const QString& hostName )
 	}
 
 	// then try to resolve ist first
-	const auto hostInfo = QHostInfo::fromName( hostName );
+	const auto hostInfo = lookupHost( hostName );
 	if( hostInfo.error() != QHostInfo::NoError || hostInfo.addresses().isEmpty() )
 	{
 		vWarning() << "could not lookup IP address of host" << hostName << "error:" << hostInfo.errorString();
@@ -187,7 +367,7 @@ QString HostAddress::toHostName( HostAddress::Type type, const QString& address
 
 	case Type::IpAddress:
 	{
-		const auto hostInfo = QHostInfo::fromName( address );
+		const auto hostInfo = lookupHost( address );
 		if( hostInfo.error() != QHostInfo::NoError )
 		{
 			vWarning() << "could not lookup hostname for IP address" << address << "error:" << hostInfo.errorString();
@@ -221,7 +401,7 @@ QString HostAddress::toFQDN( HostAddress::Type type, const QString& address )
 
 	case Type::IpAddress:
 	{
-		const auto hostInfo = QHostInfo::fromName( address );
+		const auto hostInfo = lookupHost( address );
 		if( hostInfo.error() != QHostInfo::NoError )
 		{
 			vWarning() << "could not lookup hostname for IP address" << address << "error:" << hostInfo.errorString();
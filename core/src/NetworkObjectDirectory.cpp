@@ -22,8 +22,15 @@
  *
  */
 
+#include <QDataStream>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSet>
 #include <QTimer>
+#include <QtConcurrent>
 
+#include "HostAddress.h"
 #include "VeyonConfiguration.h"
 #include "VeyonCore.h"
 #include "NetworkObjectDirectory.h"
@@ -32,12 +39,21 @@
 NetworkObjectDirectory::NetworkObjectDirectory( QObject* parent ) :
 	QObject( parent ),
 	m_updateTimer( new QTimer( this ) ),
+	m_updateWatcher( new QFutureWatcher<ObjectTree>( this ) ),
 	m_objects(),
+	m_objectRows(),
+	m_objectParents(),
+	m_typeIndex(),
+	m_attributeIndexes(),
+	m_hostLocationIndex(),
+	m_hostLocationIndexValid( false ),
 	m_invalidObject( NetworkObject::Type::None ),
 	m_rootObject( NetworkObject::Type::Root ),
 	m_defaultObjectList()
 {
-	connect( m_updateTimer, &QTimer::timeout, this, &NetworkObjectDirectory::update );
+	connect( m_updateTimer, &QTimer::timeout, this, &NetworkObjectDirectory::updateInBackground );
+	connect( m_updateWatcher, &QFutureWatcher<ObjectTree>::finished,
+			 this, &NetworkObjectDirectory::finishBackgroundUpdate );
 
 	// insert root item
 	m_objects[rootId()] = {};
@@ -45,6 +61,13 @@ NetworkObjectDirectory::NetworkObjectDirectory( QObject* parent ) :
 
 
 
+NetworkObjectDirectory::~NetworkObjectDirectory()
+{
+	waitForBackgroundUpdate();
+}
+
+
+
 void NetworkObjectDirectory::setUpdateInterval( int interval )
 {
 	if( interval >= MinimumUpdateInterval )
@@ -84,18 +107,10 @@ const NetworkObject& NetworkObjectDirectory::object( NetworkObject::ModelId pare
 		return m_rootObject;
 	}
 
-	const auto it = m_objects.constFind( parent );
-	if( it != m_objects.end() )
+	const ObjectKey key( parent, object );
+	if( m_objectRows.contains( key ) )
 	{
-		int index = 0;
-		for( const auto& entry : *it )
-		{
-			if( entry.modelId() == object )
-			{
-				return entry;
-			}
-			++index;
-		}
+		return objectAt( key );
 	}
 
 	return m_invalidObject;
@@ -105,21 +120,7 @@ const NetworkObject& NetworkObjectDirectory::object( NetworkObject::ModelId pare
 
 int NetworkObjectDirectory::index( NetworkObject::ModelId parent, NetworkObject::ModelId child ) const
 {
-	const auto it = m_objects.constFind( parent );
-	if( it != m_objects.end() )
-	{
-		int index = 0;
-		for( const auto& entry : *it )
-		{
-			if( entry.modelId() == child )
-			{
-				return index;
-			}
-			++index;
-		}
-	}
-
-	return -1;
+	return m_objectRows.value( ObjectKey( parent, child ), -1 );
 }
 
 
@@ -160,20 +161,7 @@ NetworkObject::ModelId NetworkObjectDirectory::parentId( NetworkObject::ModelId
 		return 0;
 	}
 
-	for( auto it = m_objects.constBegin(); it != m_objects.constEnd(); ++it )
-	{
-		const auto& objectList = it.value();
-
-		for( const auto& object : objectList )
-		{
-			if( object.modelId() == child )
-			{
-				return it.key();
-			}
-		}
-	}
-
-	return 0;
+	return m_objectParents.value( child, 0 );
 }
 
 
@@ -196,17 +184,54 @@ NetworkObjectList NetworkObjectDirectory::queryObjects( NetworkObject::Type type
 
 	NetworkObjectList objects;
 
-	for( auto it = m_objects.constBegin(); it != m_objects.constEnd(); ++it )
+	const auto matches = [&]( const NetworkObject& object ) {
+		return ( type == NetworkObject::Type::None || object.type() == type ) &&
+				( attribute == NetworkObject::Attribute::None ||
+				  object.isAttributeValueEqual( attribute, value, Qt::CaseInsensitive ) );
+	};
+
+	if( indexedAttributes().contains( attribute ) )
 	{
-		const auto& objectList = it.value();
+		const auto& attributeIndex = m_attributeIndexes[static_cast<int>( attribute )];
+		QSet<ObjectKey> matchedObjects;
 
-		for( const auto& object : objectList )
+		// look up candidates and verify them in order to retain exact matching semantics
+		for( const auto& key : attributeIndexKeys( attribute, value ) )
 		{
-			if( ( type == NetworkObject::Type::None || object.type() == type ) &&
-				( attribute == NetworkObject::Attribute::None ||
-				  object.isAttributeValueEqual( attribute, value, Qt::CaseInsensitive ) ) )
+			const auto candidates = attributeIndex.value( key );
+			for( const auto& objectKey : candidates )
 			{
-				objects.append( object );
+				const auto& object = objectAt( objectKey );
+				if( matchedObjects.contains( objectKey ) == false && matches( object ) )
+				{
+					matchedObjects.insert( objectKey );
+					objects.append( object );
+				}
+			}
+		}
+	}
+	else if( attribute == NetworkObject::Attribute::None && type != NetworkObject::Type::None )
+	{
+		const auto objectKeys = m_typeIndex.value( static_cast<int>( type ) );
+		objects.reserve( objectKeys.size() );
+
+		for( const auto& objectKey : objectKeys )
+		{
+			objects.append( objectAt( objectKey ) );
+		}
+	}
+	else
+	{
+		for( auto it = m_objects.constBegin(); it != m_objects.constEnd(); ++it )
+		{
+			const auto& objectList = it.value();
+
+			for( const auto& object : objectList )
+			{
+				if( matches( object ) )
+				{
+					objects.append( object );
+				}
 			}
 		}
 	}
@@ -223,25 +248,58 @@ NetworkObjectList NetworkObjectDirectory::queryParents( const NetworkObject& chi
 		update();
 	}
 
-	if( child.type() == NetworkObject::Type::Root )
+	NetworkObjectList parents;
+
+	auto parentUid = child.type() == NetworkObject::Type::Root ? NetworkObject::Uid() : child.parentUid();
+
+	// follow parent UIDs upwards via the UID index
+	const auto& uidIndex = m_attributeIndexes[static_cast<int>( NetworkObject::Attribute::Uid )];
+	while( parentUid.isNull() == false )
 	{
-		return {};
+		const auto it = uidIndex.constFind( attributeIndexKey( parentUid ) );
+		if( it == uidIndex.constEnd() || it->isEmpty() || parents.size() > m_objectRows.size() )
+		{
+			break;
+		}
+
+		const auto& parent = objectAt( *it->constBegin() );
+		parents.prepend( parent );
+		parentUid = parent.parentUid();
 	}
 
-	for( auto it = m_objects.constBegin(); it != m_objects.constEnd(); ++it )
+	return parents;
+}
+
+
+
+/*!
+ * \brief Returns the sorted names of all locations containing a host with the given address. The address
+ * is looked up in all its variants (IP address, host name, FQDN) so the result matches the host
+ * regardless of how its address has been stored in the directory.
+ */
+QStringList NetworkObjectDirectory::locationsOfHost( const QString& hostAddress )
+{
+	if( hasObjects() == false )
 	{
-		const auto& objectList = it.value();
+		update();
+	}
 
-		for( const auto& object : objectList )
-		{
-			if( object.uid() == child.parentUid() )
-			{
-				return queryParents( object ) + NetworkObjectList( { object } );
-			}
-		}
+	if( m_hostLocationIndexValid == false )
+	{
+		updateHostLocationIndex();
+	}
+
+	QStringList locations;
+
+	for( const auto& key : attributeIndexKeys( NetworkObject::Attribute::HostAddress, hostAddress ) )
+	{
+		locations.append( m_hostLocationIndex.value( key ) );
 	}
 
-	return {};
+	std::sort( locations.begin(), locations.end() );
+	locations.erase( std::unique( locations.begin(), locations.end() ), locations.end() );
+
+	return locations;
 }
 
 
@@ -258,6 +316,117 @@ void NetworkObjectDirectory::fetchObjects( const NetworkObject& object )
 
 
 
+void NetworkObjectDirectory::updateInBackground()
+{
+	if( m_updateWatcher->isRunning() )
+	{
+		return;
+	}
+
+	// query the directory backend through an independent instance in a worker thread so
+	// that the UI does not freeze and only apply the resulting differences afterwards
+	const auto directory = this;
+	const auto currentObjects = m_objects;
+	m_updateWatcher->setFuture( QtConcurrent::run( [directory, currentObjects]() -> ObjectTree {
+		QScopedPointer<NetworkObjectDirectory> snapshotDirectory( directory->clone() );
+		if( snapshotDirectory.isNull() )
+		{
+			return {};
+		}
+
+		// start with the current objects so that directories can update them incrementally
+		snapshotDirectory->applySnapshot( currentObjects, snapshotDirectory->m_rootObject );
+		snapshotDirectory->update();
+
+		return snapshotDirectory->m_objects;
+	} ) );
+}
+
+
+
+/*!
+ * \brief Loads objects from a snapshot previously written by saveSnapshot()
+ * \return true if the snapshot has been loaded successfully
+ *
+ * This allows showing the objects of the last session instantly while the
+ * directory is updated in background.
+ */
+bool NetworkObjectDirectory::loadSnapshot( const QString& fileName )
+{
+	QFile file( fileName );
+	if( file.open( QFile::ReadOnly ) == false )
+	{
+		return false;
+	}
+
+	QDataStream stream( &file );
+	stream.setVersion( QDataStream::Qt_5_5 );
+
+	quint32 magic = 0;
+	quint32 version = 0;
+	stream >> magic >> version;
+
+	if( magic != SnapshotMagic || version != SnapshotVersion )
+	{
+		vDebug() << "ignoring incompatible snapshot" << fileName;
+		return false;
+	}
+
+	ObjectTree snapshot;
+	if( readSnapshotObjects( stream, m_rootObject, snapshot ) == false ||
+		stream.status() != QDataStream::Ok )
+	{
+		vWarning() << "failed to read snapshot" << fileName;
+		return false;
+	}
+
+	applySnapshot( snapshot, m_rootObject );
+
+	vDebug() << "loaded" << m_objectRows.size() << "objects from snapshot" << fileName;
+
+	return true;
+}
+
+
+
+bool NetworkObjectDirectory::saveSnapshot( const QString& fileName ) const
+{
+	QDir().mkpath( QFileInfo( fileName ).absolutePath() );
+
+	QSaveFile file( fileName );
+	if( file.open( QFile::WriteOnly | QFile::Truncate ) == false )
+	{
+		vWarning() << "failed to open snapshot file" << fileName;
+		return false;
+	}
+
+	QDataStream stream( &file );
+	stream.setVersion( QDataStream::Qt_5_5 );
+
+	stream << SnapshotMagic << SnapshotVersion;
+
+	writeSnapshotObjects( stream, m_rootObject );
+
+	return stream.status() == QDataStream::Ok && file.commit();
+}
+
+
+
+NetworkObjectDirectory* NetworkObjectDirectory::clone() const
+{
+	return nullptr;
+}
+
+
+
+void NetworkObjectDirectory::waitForBackgroundUpdate()
+{
+	// worker thread accesses this instance while creating the snapshot directory
+	m_updateWatcher->waitForFinished();
+}
+
+
+
 bool NetworkObjectDirectory::hasObjects() const
 {
 	return m_objects.size() > 1;
@@ -280,13 +449,14 @@ void NetworkObjectDirectory::addOrUpdateObject( const NetworkObject& networkObje
 	}
 
 	auto& objectList = m_objects[parent.modelId()]; // clazy:exclude=detaching-member
-	const auto index = objectList.indexOf( completeNetworkObject );
+	const auto index = this->index( parent.modelId(), completeNetworkObject.modelId() );
 
 	if( index < 0 )
 	{
 		emit objectsAboutToBeInserted( parent, objectList.count(), 1 );
 
 		objectList.append( completeNetworkObject );
+		indexObject( completeNetworkObject, parent.modelId(), objectList.count() - 1 );
 		if( completeNetworkObject.type() == NetworkObject::Type::Location )
 		{
 			m_objects[completeNetworkObject.modelId()] = {};
@@ -296,7 +466,9 @@ void NetworkObjectDirectory::addOrUpdateObject( const NetworkObject& networkObje
 	}
 	else if( objectList[index].exactMatch( completeNetworkObject ) == false )
 	{
+		unindexObject( objectList[index], parent.modelId() );
 		objectList.replace( index, completeNetworkObject );
+		indexObject( completeNetworkObject, parent.modelId(), index );
 		emit objectChanged( parent, index );
 	}
 }
@@ -310,52 +482,382 @@ void NetworkObjectDirectory::removeObjects( const NetworkObject& parent, const N
 		return;
 	}
 
-	auto& objectList = m_objects[parent.modelId()]; // clazy:exclude=detaching-member
-	int index = 0;
-	QList<NetworkObject::ModelId> groupsToRemove;
+	const auto parentId = parent.modelId();
+	auto& objectList = m_objects[parentId]; // clazy:exclude=detaching-member
 
-	for( auto it = objectList.begin(); it != objectList.end(); )
+	// remove contiguous ranges of matching objects starting at the end so that row
+	// indexes only have to be updated once per range instead of once per object
+	int index = objectList.count() - 1;
+	while( index >= 0 )
 	{
-		if( removeObjectFilter( *it ) )
+		if( removeObjectFilter( objectList.at( index ) ) == false )
+		{
+			--index;
+			continue;
+		}
+
+		const auto last = index;
+		while( index > 0 && removeObjectFilter( objectList.at( index-1 ) ) )
+		{
+			--index;
+		}
+		const auto count = last - index + 1;
+
+		emit objectsAboutToBeRemoved( parent, index, count );
+
+		for( int i = index; i <= last; ++i )
 		{
-			if( it->type() == NetworkObject::Type::Location )
+			const auto& object = objectList.at( i );
+			if( object.type() == NetworkObject::Type::Location )
 			{
-				groupsToRemove.append( it->modelId() );
+				unindexChildren( object.modelId() );
+				m_objects.remove( object.modelId() );
 			}
+			unindexObject( object, parentId );
+		}
+
+		objectList.erase( objectList.begin() + index, objectList.begin() + last + 1 );
+		updateRows( parentId, index );
+
+		emit objectsRemoved();
+
+		--index;
+	}
+}
+
+
+
+void NetworkObjectDirectory::setObjectPopulated( const NetworkObject& networkObject )
+{
+	const auto objectModelId = networkObject.modelId();
+
+	for( auto it = m_objectParents.find( objectModelId ); it != m_objectParents.end() && it.key() == objectModelId; ++it )
+	{
+		const auto row = m_objectRows.value( ObjectKey( it.value(), objectModelId ), -1 );
+		auto objectList = m_objects.find( it.value() ); // clazy:exclude=detaching-member
+		if( row >= 0 && objectList != m_objects.end() && row < objectList->count() )
+		{
+			( *objectList )[row].setPopulated();
+		}
+	}
+}
 
-			emit objectsAboutToBeRemoved( parent, index, 1 );
-			it = objectList.erase( it );
-			emit objectsRemoved();
+
+
+void NetworkObjectDirectory::writeSnapshotObjects( QDataStream& stream, const NetworkObject& parent ) const
+{
+	const auto objects = m_objects.value( parent.modelId() );
+
+	stream << quint32( objects.count() );
+
+	for( const auto& object : objects )
+	{
+		stream << quint8( object.type() )
+			   << object.name()
+			   << object.hostAddress()
+			   << object.macAddress()
+			   << object.directoryAddress()
+			   << object.uid()
+			   << object.parentUid();
+
+		// children of locations directly follow the location object
+		if( object.type() == NetworkObject::Type::Location )
+		{
+			writeSnapshotObjects( stream, object );
 		}
-		else
+	}
+}
+
+
+
+bool NetworkObjectDirectory::readSnapshotObjects( QDataStream& stream, const NetworkObject& parent, ObjectTree& snapshot ) const
+{
+	quint32 count = 0;
+	stream >> count;
+
+	auto& objects = snapshot[parent.modelId()];
+
+	for( quint32 i = 0; i < count; ++i )
+	{
+		quint8 type = 0;
+		QString name;
+		QString hostAddress;
+		QString macAddress;
+		QString directoryAddress;
+		NetworkObject::Uid uid;
+		NetworkObject::Uid parentUid;
+
+		stream >> type >> name >> hostAddress >> macAddress >> directoryAddress >> uid >> parentUid;
+
+		if( stream.status() != QDataStream::Ok ||
+			type >= quint8( NetworkObject::Type::TypeCount ) )
+		{
+			return false;
+		}
+
+		const NetworkObject object( NetworkObject::Type( type ), name, hostAddress, macAddress,
+									directoryAddress, uid, parentUid );
+		objects.append( object );
+
+		if( object.type() == NetworkObject::Type::Location &&
+			readSnapshotObjects( stream, object, snapshot ) == false )
 		{
-			++it;
-			++index;
+			return false;
 		}
 	}
 
-	for( const auto& groupId : groupsToRemove )
+	return true;
+}
+
+
+
+void NetworkObjectDirectory::finishBackgroundUpdate()
+{
+	const auto snapshot = m_updateWatcher->result();
+
+	// directories which can't be cloned are updated synchronously
+	if( snapshot.isEmpty() )
 	{
-		m_objects.remove( groupId );
+		update();
 	}
+	else
+	{
+		applySnapshot( snapshot, m_rootObject );
+	}
+
+	emit updated();
 }
 
 
 
-void NetworkObjectDirectory::setObjectPopulated( const NetworkObject& networkObject )
+void NetworkObjectDirectory::applySnapshot( const ObjectTree& snapshot, const NetworkObject& parent )
 {
-	const auto objectModelId = networkObject.modelId();
+	const auto objects = snapshot.value( parent.modelId() );
 
-	auto it = m_objects.find( parentId( objectModelId ) ); // clazy:exclude=detaching-member
-	if( it != m_objects.end() )
+	addObjects( objects, parent );
+
+	QSet<NetworkObject::Uid> uids;
+	for( const auto& object : objects )
+	{
+		uids.insert( object.uid() );
+	}
+
+	removeObjects( parent, [&uids]( const NetworkObject& object ) {
+		return uids.contains( object.uid() ) == false; } );
+
+	for( const auto& object : objects )
+	{
+		if( object.type() == NetworkObject::Type::Location )
+		{
+			applySnapshot( snapshot, object );
+		}
+	}
+}
+
+
+
+void NetworkObjectDirectory::addObjects( const NetworkObjectList& objects, const NetworkObject& parent )
+{
+	auto& objectList = m_objects[parent.modelId()]; // clazy:exclude=detaching-member
+
+	NetworkObjectList newObjects;
+
+	for( const auto& object : objects )
+	{
+		const auto index = this->index( parent.modelId(), object.modelId() );
+		if( index < 0 )
+		{
+			newObjects.append( object );
+		}
+		else if( objectList[index].exactMatch( object ) == false )
+		{
+			unindexObject( objectList[index], parent.modelId() );
+			objectList.replace( index, object );
+			indexObject( object, parent.modelId(), index );
+			emit objectChanged( parent, index );
+		}
+	}
+
+	if( newObjects.isEmpty() )
+	{
+		return;
+	}
+
+	// insert all new objects at once so attached models only have to process one change
+	emit objectsAboutToBeInserted( parent, objectList.count(), newObjects.count() );
+
+	for( const auto& object : qAsConst(newObjects) )
+	{
+		objectList.append( object );
+		indexObject( object, parent.modelId(), objectList.count() - 1 );
+		if( object.type() == NetworkObject::Type::Location )
+		{
+			m_objects[object.modelId()] = {};
+		}
+	}
+
+	emit objectsInserted();
+}
+
+
+
+const NetworkObject& NetworkObjectDirectory::objectAt( const ObjectKey& key ) const
+{
+	const auto it = m_objects.constFind( key.first );
+	const auto row = m_objectRows.value( key, -1 );
+
+	if( it != m_objects.constEnd() && row >= 0 && row < it->count() )
+	{
+		return it->at( row );
+	}
+
+	return m_invalidObject;
+}
+
+
+
+void NetworkObjectDirectory::indexObject( const NetworkObject& networkObject, NetworkObject::ModelId parent, int row )
+{
+	const ObjectKey key( parent, networkObject.modelId() );
+
+	m_objectRows[key] = row;
+	m_hostLocationIndexValid = false;
+
+	if( m_objectParents.contains( key.second, parent ) == false )
+	{
+		m_objectParents.insert( key.second, parent );
+	}
+	m_typeIndex[static_cast<int>( networkObject.type() )].insert( key );
+
+	for( const auto attribute : indexedAttributes() )
+	{
+		m_attributeIndexes[static_cast<int>( attribute )][attributeIndexKey( networkObject.attributeValue( attribute ) )].
+				insert( key );
+	}
+}
+
+
+
+void NetworkObjectDirectory::unindexObject( const NetworkObject& networkObject, NetworkObject::ModelId parent )
+{
+	const ObjectKey key( parent, networkObject.modelId() );
+
+	m_objectRows.remove( key );
+	m_hostLocationIndexValid = false;
+
+	m_objectParents.remove( key.second, parent );
+	removeFromIndex( m_typeIndex, static_cast<int>( networkObject.type() ), key );
+
+	for( const auto attribute : indexedAttributes() )
 	{
-		for( auto& entry : *it )
+		removeFromIndex( m_attributeIndexes[static_cast<int>( attribute )],
+						 attributeIndexKey( networkObject.attributeValue( attribute ) ), key );
+	}
+}
+
+
+
+void NetworkObjectDirectory::unindexChildren( NetworkObject::ModelId parent )
+{
+	const auto children = m_objects.value( parent );
+
+	for( const auto& child : children )
+	{
+		if( child.type() == NetworkObject::Type::Location && child.modelId() != parent )
 		{
-			if( entry.modelId() == objectModelId )
+			unindexChildren( child.modelId() );
+			m_objects.remove( child.modelId() );
+		}
+		unindexObject( child, parent );
+	}
+}
+
+
+
+void NetworkObjectDirectory::updateRows( NetworkObject::ModelId parent, int firstRow )
+{
+	const auto& objectList = m_objects[parent]; // clazy:exclude=detaching-member
+
+	for( int row = firstRow; row < objectList.count(); ++row )
+	{
+		m_objectRows[ObjectKey( parent, objectList[row].modelId() )] = row;
+	}
+}
+
+
+
+void NetworkObjectDirectory::updateHostLocationIndex()
+{
+	m_hostLocationIndex.clear();
+
+	const auto hostKeys = m_typeIndex.value( static_cast<int>( NetworkObject::Type::Host ) );
+	for( const auto& hostKey : hostKeys )
+	{
+		const auto& host = objectAt( hostKey );
+		const auto key = attributeIndexKey( host.hostAddress() );
+		if( key.isEmpty() )
+		{
+			continue;
+		}
+
+		auto& locations = m_hostLocationIndex[key];
+
+		const auto parents = NetworkObjectDirectory::queryParents( host );
+		for( const auto& parent : parents )
+		{
+			locations.append( parent.name() );
+		}
+	}
+
+	m_hostLocationIndexValid = true;
+}
+
+
+
+QString NetworkObjectDirectory::attributeIndexKey( const QVariant& value )
+{
+	return value.toString().toLower();
+}
+
+
+
+QStringList NetworkObjectDirectory::attributeIndexKeys( NetworkObject::Attribute attribute, const QVariant& value )
+{
+	QStringList keys( { attributeIndexKey( value ) } );
+
+	// host addresses are compared after converting the queried address to the type of the stored address
+	if( attribute == NetworkObject::Attribute::HostAddress && value.userType() == QMetaType::QString )
+	{
+		const HostAddress hostAddress( value.toString() );
+		for( const auto type : { HostAddress::Type::IpAddress, HostAddress::Type::HostName,
+								 HostAddress::Type::FullyQualifiedDomainName } )
+		{
+			if( type != hostAddress.type() )
 			{
-				entry.setPopulated();
-				break;
+				const auto key = attributeIndexKey( hostAddress.convert( type ) );
+				if( key.isEmpty() == false && keys.contains( key ) == false )
+				{
+					keys.append( key );
+				}
 			}
 		}
 	}
+
+	return keys;
+}
+
+
+
+const QList<NetworkObject::Attribute>& NetworkObjectDirectory::indexedAttributes()
+{
+	static const QList<NetworkObject::Attribute> attributes( {
+		NetworkObject::Attribute::Name,
+		NetworkObject::Attribute::HostAddress,
+		NetworkObject::Attribute::MacAddress,
+		NetworkObject::Attribute::DirectoryAddress,
+		NetworkObject::Attribute::Uid,
+		NetworkObject::Attribute::ParentUid
+	} );
+
+	return attributes;
 }
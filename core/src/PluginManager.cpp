@@ -24,11 +24,23 @@
 
 #include <QCoreApplication>
 #include <QDir>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QPluginLoader>
+#include <QStandardPaths>
 
+#include "AuthenticationPluginInterface.h"
+#include "CommandLinePluginInterface.h"
+#include "ConfigurationPagePluginInterface.h"
+#include "FeatureProviderInterface.h"
 #include "Logger.h"
+#include "NetworkObjectDirectoryPluginInterface.h"
+#include "PlatformPluginInterface.h"
 #include "PluginManager.h"
+#include "UserGroupsBackendInterface.h"
 #include "VeyonConfiguration.h"
+#include "VncServerPluginInterface.h"
 
 
 PluginManager::PluginManager( QObject* parent ) :
@@ -36,6 +48,7 @@ PluginManager::PluginManager( QObject* parent ) :
 	m_pluginInterfaces(),
 	m_pluginObjects(),
 	m_pluginLoaders(),
+	m_manifest(),
 	m_noDebugMessages( qEnvironmentVariableIsSet( Logger::logLevelEnvironmentVariable() ) )
 {
 	initPluginSearchPath();
@@ -65,9 +78,18 @@ void PluginManager::loadPlatformPlugins()
 
 
 
-void PluginManager::loadPlugins()
+void PluginManager::loadPlugins( const QStringList& requiredFeatures )
 {
-	loadPlugins( QStringLiteral("*") + VeyonCore::sharedLibrarySuffix() );
+	QElapsedTimer loadTimer;
+	loadTimer.start();
+
+	if( requiredFeatures.isEmpty() || loadRequiredPlugins( requiredFeatures ) == false )
+	{
+		loadPlugins( QStringLiteral("*") + VeyonCore::sharedLibrarySuffix() );
+		writeManifest();
+	}
+
+	vDebug() << "loaded" << m_pluginInterfaces.count() << "plugins in" << loadTimer.elapsed() << "ms";
 
 	emit pluginsLoaded();
 }
@@ -167,6 +189,135 @@ void PluginManager::initPluginSearchPath()
 
 void PluginManager::loadPlugins( const QString& nameFilter )
 {
+	m_manifest = {};
+
+	const auto plugins = pluginFiles( nameFilter );
+	for( const auto& fileInfo : plugins )
+	{
+		QJsonObject manifestEntry{
+			{ QStringLiteral("File"), fileInfo.fileName() },
+			{ QStringLiteral("Size"), fileInfo.size() },
+			{ QStringLiteral("LastModified"), fileInfo.lastModified().toMSecsSinceEpoch() }
+		};
+
+		loadPlugin( fileInfo, &manifestEntry );
+
+		m_manifest.append( manifestEntry );
+	}
+}
+
+
+
+bool PluginManager::loadRequiredPlugins( const QStringList& requiredFeatures )
+{
+	const auto plugins = pluginFiles( QStringLiteral("*") + VeyonCore::sharedLibrarySuffix() );
+	const auto manifest = readManifest( plugins );
+	if( manifest.isEmpty() )
+	{
+		vDebug() << "plugin manifest missing or outdated";
+		return false;
+	}
+
+	for( int i = 0; i < manifest.count(); ++i )
+	{
+		const auto manifestEntry = manifest[i].toObject();
+		const auto interfaces = manifestEntry.value( QStringLiteral("Interfaces") ).toVariant().toStringList();
+		const auto features = manifestEntry.value( QStringLiteral("Features") ).toVariant().toStringList();
+
+		// authentication plugins are always required by AuthenticationManager
+		bool required = interfaces.contains( QLatin1String(AuthenticationPluginInterface_iid) );
+
+		for( const auto& feature : features )
+		{
+			required |= requiredFeatures.contains( feature );
+		}
+
+		if( required && loadPlugin( plugins[i] ) == false )
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+
+bool PluginManager::loadPlugin( const QFileInfo& fileInfo, QJsonObject* manifestEntry )
+{
+	auto pluginLoader = new QPluginLoader( fileInfo.filePath(), this );
+	auto pluginObject = pluginLoader->instance();
+	auto pluginInterface = qobject_cast<PluginInterface *>( pluginObject );
+
+	if( pluginObject == nullptr || pluginInterface == nullptr )
+	{
+		delete pluginLoader;
+		return false;
+	}
+
+	if( manifestEntry )
+	{
+		static const QStringList knownInterfaces{
+			QStringLiteral(AuthenticationPluginInterface_iid),
+			QStringLiteral(CommandLinePluginInterface_iid),
+			QStringLiteral(ConfigurationPagePluginInterface_iid),
+			QStringLiteral(FeatureProviderInterface_iid),
+			QStringLiteral(NetworkObjectDirectoryPluginInterface_iid),
+			QStringLiteral(PlatformPluginInterface_iid),
+			QStringLiteral(UserGroupsBackendInterface_iid),
+			QStringLiteral(VncServerPluginInterface_iid)
+		};
+
+		QStringList interfaces;
+		for( const auto& iid : knownInterfaces )
+		{
+			if( pluginObject->qt_metacast( iid.toLatin1().constData() ) )
+			{
+				interfaces.append( iid );
+			}
+		}
+
+		QStringList features;
+		auto featureProviderInterface = qobject_cast<FeatureProviderInterface *>( pluginObject );
+		if( featureProviderInterface )
+		{
+			for( const auto& feature : featureProviderInterface->featureList() )
+			{
+				features.append( feature.uid().toString() );
+			}
+		}
+
+		(*manifestEntry)[QStringLiteral("Uid")] = pluginInterface->uid().toString();
+		(*manifestEntry)[QStringLiteral("Name")] = pluginInterface->name();
+		(*manifestEntry)[QStringLiteral("Interfaces")] = QJsonArray::fromStringList( interfaces );
+		(*manifestEntry)[QStringLiteral("Features")] = QJsonArray::fromStringList( features );
+	}
+
+	// plugin already loaded (e.g. platform plugins)?
+	if( m_pluginInterfaces.contains( pluginInterface ) )
+	{
+		delete pluginLoader;
+		return true;
+	}
+
+	if( m_noDebugMessages == false )
+	{
+		vDebug() << "discovered plugin" << pluginInterface->name() << "at" << fileInfo.filePath();
+	}
+
+	m_pluginInterfaces += pluginInterface;	// clazy:exclude=reserve-candidates
+	m_pluginObjects += pluginObject;		// clazy:exclude=reserve-candidates
+	m_pluginLoaders += pluginLoader;			// clazy:exclude=reserve-candidates
+
+	return true;
+}
+
+
+
+QFileInfoList PluginManager::pluginFiles( const QString& nameFilter ) const
+{
+	QFileInfoList files;
+
 	const auto plugins = QDir( QStringLiteral( "plugins:" ) ).entryInfoList( { nameFilter } );
 	for( const auto& fileInfo : plugins )
 	{
@@ -179,24 +330,83 @@ void PluginManager::loadPlugins( const QString& nameFilter )
 			continue;
 		}
 
-		auto pluginLoader = new QPluginLoader( fileInfo.filePath(), this );
-		auto pluginObject = pluginLoader->instance();
-		auto pluginInterface = qobject_cast<PluginInterface *>( pluginObject );
+		files.append( fileInfo );
+	}
 
-		if( pluginObject && pluginInterface &&
-			m_pluginInterfaces.contains( pluginInterface ) == false )
-		{
-			if( m_noDebugMessages == false )
-			{
-				vDebug() << "discovered plugin" << pluginInterface->name() << "at" << fileInfo.filePath();
-			}
-			m_pluginInterfaces += pluginInterface;	// clazy:exclude=reserve-candidates
-			m_pluginObjects += pluginObject;		// clazy:exclude=reserve-candidates
-			m_pluginLoaders += pluginLoader;			// clazy:exclude=reserve-candidates
-		}
-		else
+	return files;
+}
+
+
+
+QString PluginManager::manifestFilePath()
+{
+	return QDir( QStandardPaths::writableLocation( QStandardPaths::CacheLocation ) ).
+			filePath( QLatin1String(ManifestFileName) );
+}
+
+
+
+QJsonArray PluginManager::readManifest( const QFileInfoList& plugins ) const
+{
+	QFile manifestFile( manifestFilePath() );
+	if( manifestFile.open( QFile::ReadOnly ) == false )
+	{
+		return {};
+	}
+
+	const auto manifestObject = QJsonDocument::fromJson( manifestFile.readAll() ).object();
+	if( manifestObject.value( QStringLiteral("Version") ).toString() != VeyonCore::versionString() )
+	{
+		return {};
+	}
+
+	const auto manifest = manifestObject.value( QStringLiteral("Plugins") ).toArray();
+
+	// manifest is only valid if it matches the plugin files currently installed
+	if( plugins.count() != manifest.count() )
+	{
+		return {};
+	}
+
+	for( int i = 0; i < plugins.count(); ++i )
+	{
+		const auto manifestEntry = manifest[i].toObject();
+		if( manifestEntry.value( QStringLiteral("File") ).toString() != plugins[i].fileName() ||
+			manifestEntry.value( QStringLiteral("Size") ).toVariant().toLongLong() != plugins[i].size() ||
+			manifestEntry.value( QStringLiteral("LastModified") ).toVariant().toLongLong() !=
+				plugins[i].lastModified().toMSecsSinceEpoch() )
 		{
-			delete pluginLoader;
+			return {};
 		}
 	}
+
+	return manifest;
+}
+
+
+
+void PluginManager::writeManifest()
+{
+	const QJsonObject manifestObject{
+		{ QStringLiteral("Version"), VeyonCore::versionString() },
+		{ QStringLiteral("Plugins"), m_manifest }
+	};
+
+	const auto manifestData = QJsonDocument( manifestObject ).toJson( QJsonDocument::Compact );
+
+	QFile manifestFile( manifestFilePath() );
+	if( manifestFile.open( QFile::ReadOnly ) && manifestFile.readAll() == manifestData )
+	{
+		return;
+	}
+
+	manifestFile.close();
+
+	QDir().mkpath( QFileInfo( manifestFile ).absolutePath() );
+
+	if( manifestFile.open( QFile::WriteOnly | QFile::Truncate ) == false ||
+		manifestFile.write( manifestData ) != manifestData.size() )
+	{
+		vWarning() << "could not write plugin manifest" << manifestFile.fileName();
+	}
 }
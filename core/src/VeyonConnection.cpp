@@ -24,7 +24,12 @@
 
 #include "rfb/rfbclient.h"
 
+#include <QDateTime>
+#include <QMessageAuthenticationCode>
+#include <QMutex>
+
 #include "AuthenticationManager.h"
+#include "CryptoCore.h"
 #include "PlatformUserFunctions.h"
 #include "SocketDevice.h"
 #include "VariantArrayMessage.h"
@@ -36,6 +41,10 @@
 static rfbClientProtocolExtension* __veyonProtocolExt = nullptr;
 static const uint32_t __veyonSecurityTypes[2] = { VeyonCore::RfbSecurityTypeVeyon, 0 };
 
+// session tickets received from servers (indexed by host and port)
+static QMutex __sessionTicketsMutex;
+static QHash<QString, VeyonConnection::SessionTicket> __sessionTickets;
+
 
 rfbBool handleVeyonMessage( rfbClient* client, rfbServerToClientMsg* msg )
 {
@@ -185,6 +194,17 @@ int8_t VeyonConnection::handleSecTypeVeyon( rfbClient* client, uint32_t authSche
 		}
 	}
 
+	const auto sessionTicketsSupported = authTypes.contains( AuthenticationManager::sessionTicketUid() );
+	const auto sessionTicketKey = QStringLiteral("%1:%2").arg( QString::fromUtf8( client->serverHost ) ).arg( client->serverPort );
+
+	// try to resume previous session - the server accepts each ticket only once so
+	// drop it regardless of whether resuming the session succeeds
+	const auto sessionTicket = sessionTicketsSupported ? takeSessionTicket( sessionTicketKey ) : SessionTicket();
+	if( sessionTicket.ticket.isEmpty() == false )
+	{
+		chosenAuthPlugin = AuthenticationManager::sessionTicketUid();
+	}
+
 	if( chosenAuthPlugin.isNull() )
 	{
 		vWarning() << QThread::currentThreadId() << "authentication plugins not supported "
@@ -200,12 +220,96 @@ int8_t VeyonConnection::handleSecTypeVeyon( rfbClient* client, uint32_t authSche
 
 	// send username which is used when displaying an access confirm dialog
 	authReplyMessage.write( VeyonCore::platform().userFunctions().currentUser() );
+	authReplyMessage.write( sessionTicketsSupported );
+
+	// public key for agreeing on the secret of the session ticket issued after successful authentication
+	const auto sessionTicketPrivateKey = sessionTicketsSupported ? CryptoCore::createX25519PrivateKey() : CryptoCore::SecureArray();
+	authReplyMessage.write( CryptoCore::x25519PublicKey( sessionTicketPrivateKey ) );
 	authReplyMessage.send();
 
 	VariantArrayMessage authAckMessage( &socketDevice );
 	authAckMessage.receive();
 
-	return plugins[chosenAuthPlugin]->authenticate( &socketDevice );
+	if( sessionTicket.ticket.isEmpty() == false )
+	{
+		VariantArrayMessage challengeReceiveMessage( &socketDevice );
+		challengeReceiveMessage.receive();
+		const auto challenge = challengeReceiveMessage.read().toByteArray();
+
+		if( challenge.size() != CryptoCore::ChallengeSize )
+		{
+			vCritical() << QThread::currentThreadId() << "challenge size mismatch!";
+			return false;
+		}
+
+		// prove possession of the ticket secret which has never been transmitted so that eavesdropped tickets are useless
+		VariantArrayMessage( &socketDevice ).write( sessionTicket.ticket )
+				.write( QMessageAuthenticationCode::hash( challenge, sessionTicket.secret, QCryptographicHash::Sha256 ) )
+				.send();
+	}
+	else if( plugins[chosenAuthPlugin]->authenticate( &socketDevice ) == false )
+	{
+		return false;
+	}
+
+	if( sessionTicketsSupported )
+	{
+		VariantArrayMessage sessionTicketMessage( &socketDevice );
+		if( sessionTicketMessage.receive() == false )
+		{
+			return false;
+		}
+
+		// server issues a new ticket on every successful authentication including resumed
+		// sessions, however tickets of resumed sessions expire along with the initial ticket
+		SessionTicket newSessionTicket;
+		newSessionTicket.ticket = sessionTicketMessage.read().toByteArray();
+
+		const auto sharedSecret = CryptoCore::deriveX25519SharedSecret( sessionTicketPrivateKey,
+																		sessionTicketMessage.read().toByteArray() );
+
+		if( newSessionTicket.ticket.isEmpty() == false && sharedSecret.isEmpty() == false )
+		{
+			newSessionTicket.secret = AuthenticationManager::sessionTicketSecret( sharedSecret.toByteArray(),
+																				  newSessionTicket.ticket );
+
+			// expire a bit earlier than the server does to account for transmission delays
+			newSessionTicket.expiry = QDateTime::currentMSecsSinceEpoch() +
+									  AuthenticationManager::SessionTicketLifetime - SessionTicketExpiryMargin;
+			if( sessionTicket.ticket.isEmpty() == false )
+			{
+				newSessionTicket.expiry = qMin( newSessionTicket.expiry, sessionTicket.expiry );
+			}
+
+			storeSessionTicket( sessionTicketKey, newSessionTicket );
+		}
+	}
+
+	return true;
+}
+
+
+
+VeyonConnection::SessionTicket VeyonConnection::takeSessionTicket( const QString& key )
+{
+	QMutexLocker locker( &__sessionTicketsMutex );
+
+	const auto sessionTicket = __sessionTickets.take( key );
+	if( sessionTicket.expiry > QDateTime::currentMSecsSinceEpoch() )
+	{
+		return sessionTicket;
+	}
+
+	return {};
+}
+
+
+
+void VeyonConnection::storeSessionTicket( const QString& key, const SessionTicket& sessionTicket )
+{
+	QMutexLocker locker( &__sessionTicketsMutex );
+
+	__sessionTickets[key] = sessionTicket;
 }
 
 
@@ -30,6 +30,7 @@
 #include <QAction>
 #include <QApplication>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QGroupBox>
 #include <QHostAddress>
 #include <QLabel>
@@ -57,7 +58,8 @@
 VeyonCore* VeyonCore::s_instance = nullptr;
 
 
-VeyonCore::VeyonCore( QCoreApplication* application, Component component, const QString& appComponentName ) :
+VeyonCore::VeyonCore( QCoreApplication* application, Component component, const QString& appComponentName,
+					  const QStringList& requiredFeatures ) :
 	QObject( application ),
 	m_filesystem( new Filesystem ),
 	m_config( nullptr ),
@@ -80,6 +82,9 @@ VeyonCore::VeyonCore( QCoreApplication* application, Component component, const
 
 	s_instance = this;
 
+	QElapsedTimer initTimer;
+	initTimer.start();
+
 	setupApplicationParameters();
 
 	initPlatformPlugin();
@@ -96,13 +101,15 @@ VeyonCore::VeyonCore( QCoreApplication* application, Component component, const
 
 	initAuthenticationCredentials();
 
-	initPlugins();
+	initPlugins( requiredFeatures );
 
 	initManagers();
 
 	initLocalComputerControlInterface();
 
 	initSystemInfo();
+
+	vDebug() << "initialized in" << initTimer.elapsed() << "ms";
 }
 
 
@@ -631,10 +638,10 @@ void VeyonCore::initAuthenticationCredentials()
 
 
 
-void VeyonCore::initPlugins()
+void VeyonCore::initPlugins( const QStringList& requiredFeatures )
 {
-	// load all other (non-platform) plugins
-	m_pluginManager->loadPlugins();
+	// load all other (non-platform) plugins or only the ones providing the required features
+	m_pluginManager->loadPlugins( requiredFeatures );
 	m_pluginManager->upgradePlugins();
 
 	m_builtinFeatures = new BuiltinFeatures();
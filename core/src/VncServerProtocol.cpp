@@ -27,6 +27,7 @@
 #include <QHostAddress>
 #include <QTcpSocket>
 #include "AuthenticationCredentials.h"
+#include "AuthenticationManager.h"
 #include "VariantArrayMessage.h"
 #include "VncServerClient.h"
 #include "VncServerProtocol.h"
@@ -214,8 +215,15 @@ bool VncServerProtocol::receiveAuthenticationTypeResponse()
 
 		const auto username = message.read().toString();
 
+		// clients supporting session tickets expect a ticket after successful authentication
+		const auto sessionTicketsSupported = message.read().toBool() &&
+				supportedAuthPluginUids().contains( AuthenticationManager::sessionTicketUid() );
+		const auto sessionTicketPublicKey = message.read().toByteArray();
+
 		m_client->setAuthPluginUid( chosenAuthPluginUid  );
 		m_client->setUsername( username );
+		m_client->setSessionTicketsSupported( sessionTicketsSupported );
+		m_client->setSessionTicketPublicKey( sessionTicketPublicKey );
 		m_client->setHostAddress( m_socket->peerAddress().toString() );
 
 		setState( Authenticating );
@@ -255,6 +263,12 @@ bool VncServerProtocol::processAuthentication( VariantArrayMessage& message )
 	{
 	case VncServerClient::AuthState::Successful:
 	{
+		if( m_client->sessionTicketsSupported() )
+		{
+			const auto sessionTicket = issueSessionTicket();
+			VariantArrayMessage( m_socket ).write( sessionTicket.first ).write( sessionTicket.second ).send();
+		}
+
 		const auto authResult = qToBigEndian<uint32_t>(rfbVncAuthOK);
 		m_socket->write( reinterpret_cast<const char *>( &authResult ), sizeof(authResult) );
 
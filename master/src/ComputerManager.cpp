@@ -23,12 +23,15 @@
  */
 
 #include <QCoreApplication>
+#include <QDir>
 #include <QFile>
 #include <QHostAddress>
 #include <QHostInfo>
 #include <QMessageBox>
+#include <QStandardPaths>
 
 #include "ComputerManager.h"
+#include "HostAddress.h"
 #include "VeyonConfiguration.h"
 #include "NetworkObject.h"
 #include "NetworkObjectDirectory.h"
@@ -48,7 +51,8 @@ ComputerManager::ComputerManager( UserConfig& config, QObject* parent ) :
 	m_computerTreeModel( new CheckableItemProxyModel( NetworkObjectModel::UidRole, this ) ),
 	m_networkObjectFilterProxyModel( new NetworkObjectFilterProxyModel( this ) ),
 	m_localHostNames( QHostInfo::localHostName().toLower() ),
-	m_localHostAddresses( QHostInfo::fromName( QHostInfo::localHostName() ).addresses() )
+	m_localHostAddresses( HostAddress( QHostInfo::localHostName() ).addresses() ),
+	m_networkObjectsLoaded( false )
 {
 	if( m_networkObjectDirectory == nullptr )
 	{
@@ -68,16 +72,19 @@ ComputerManager::ComputerManager( UserConfig& config, QObject* parent ) :
 								 QHostInfo::localDomainName().toLower() );
 	}
 
-	initNetworkObjectLayer();
-	initLocations();
 	initComputerTreeModel();
+	initNetworkObjectLayer();
 }
 
 
 
 ComputerManager::~ComputerManager()
 {
-	m_config.setCheckedNetworkObjects( m_computerTreeModel->saveStates() );
+	// do not overwrite saved selection if network objects have not been loaded yet
+	if( m_networkObjectsLoaded )
+	{
+		m_config.setCheckedNetworkObjects( m_computerTreeModel->saveStates() );
+	}
 }
 
 
@@ -206,8 +213,6 @@ void ComputerManager::initLocations()
 
 void ComputerManager::initNetworkObjectLayer()
 {
-	m_networkObjectDirectory->update();
-	m_networkObjectDirectory->setUpdateInterval( VeyonCore::config().networkObjectDirectoryUpdateInterval() );
 	m_networkObjectOverlayDataModel->setSourceModel( m_networkObjectModel );
 	m_networkObjectFilterProxyModel->setSourceModel( m_networkObjectOverlayDataModel );
 	m_computerTreeModel->setException( NetworkObjectModel::TypeRole, QVariant::fromValue( NetworkObject::Type::Label ) );
@@ -234,11 +239,41 @@ void ComputerManager::initNetworkObjectLayer()
 	}
 
 	m_networkObjectFilterProxyModel->setEmptyGroupsExcluded( VeyonCore::config().hideEmptyLocations() );
+
+	connect( m_networkObjectDirectory, &NetworkObjectDirectory::updated,
+			 this, &ComputerManager::handleNetworkObjectDirectoryUpdate );
+
+	// show network objects of previous session immediately if available
+	if( m_networkObjectDirectory->loadSnapshot( networkObjectDirectorySnapshotFilePath() ) )
+	{
+		initNetworkObjects();
+	}
+
+	// (re)load network objects in background and initialize locations and selection afterwards if required
+	m_networkObjectDirectory->updateInBackground();
+	m_networkObjectDirectory->setUpdateInterval( VeyonCore::config().networkObjectDirectoryUpdateInterval() );
 }
 
 
 
 void ComputerManager::initComputerTreeModel()
+{
+	connect( computerTreeModel(), &QAbstractItemModel::modelReset,
+			 this, &ComputerManager::computerSelectionReset );
+	connect( computerTreeModel(), &QAbstractItemModel::layoutChanged,
+			 this, &ComputerManager::computerSelectionReset );
+
+	connect( computerTreeModel(), &QAbstractItemModel::dataChanged,
+			 this, &ComputerManager::checkChangedData );
+	connect( computerTreeModel(), &QAbstractItemModel::rowsInserted,
+			 this, &ComputerManager::computerSelectionChanged );
+	connect( computerTreeModel(), &QAbstractItemModel::rowsRemoved,
+			 this, &ComputerManager::computerSelectionChanged );
+}
+
+
+
+void ComputerManager::initComputerSelection()
 {
 	QJsonArray checkedNetworkObjects;
 	if( VeyonCore::config().autoSelectCurrentLocation() )
@@ -258,18 +293,37 @@ void ComputerManager::initComputerTreeModel()
 	}
 
 	m_computerTreeModel->loadStates( checkedNetworkObjects );
+}
 
-	connect( computerTreeModel(), &QAbstractItemModel::modelReset,
-			 this, &ComputerManager::computerSelectionReset );
-	connect( computerTreeModel(), &QAbstractItemModel::layoutChanged,
-			 this, &ComputerManager::computerSelectionReset );
 
-	connect( computerTreeModel(), &QAbstractItemModel::dataChanged,
-			 this, &ComputerManager::checkChangedData );
-	connect( computerTreeModel(), &QAbstractItemModel::rowsInserted,
-			 this, &ComputerManager::computerSelectionChanged );
-	connect( computerTreeModel(), &QAbstractItemModel::rowsRemoved,
-			 this, &ComputerManager::computerSelectionChanged );
+
+void ComputerManager::initNetworkObjects()
+{
+	if( m_networkObjectsLoaded == false )
+	{
+		m_networkObjectsLoaded = true;
+
+		initLocations();
+		initComputerSelection();
+	}
+}
+
+
+
+void ComputerManager::handleNetworkObjectDirectoryUpdate()
+{
+	initNetworkObjects();
+
+	m_networkObjectDirectory->saveSnapshot( networkObjectDirectorySnapshotFilePath() );
+}
+
+
+
+QString ComputerManager::networkObjectDirectorySnapshotFilePath()
+{
+	return QDir( QStandardPaths::writableLocation( QStandardPaths::CacheLocation ) ).
+			filePath( QStringLiteral("NetworkObjectDirectory-%1.dat").
+					  arg( VeyonCore::formattedUuid( VeyonCore::config().networkObjectDirectoryPlugin() ) ) );
 }
 
 
@@ -69,6 +69,9 @@ private:
 	void initLocations();
 	void initNetworkObjectLayer();
 	void initComputerTreeModel();
+	void initComputerSelection();
+	void initNetworkObjects();
+	void handleNetworkObjectDirectoryUpdate();
 	void updateLocationFilterList();
 
 	QString findLocationOfComputer( const QStringList& hostNames, const QList<QHostAddress>& hostAddresses, const QModelIndex& parent );
@@ -79,6 +82,8 @@ private:
 
 	QModelIndex mapToUserNameModelIndex( const QModelIndex& networkObjectIndex );
 
+	static QString networkObjectDirectorySnapshotFilePath();
+
 	static constexpr int OverlayDataUsernameColumn = 1;
 
 	UserConfig& m_config;
@@ -95,4 +100,6 @@ private:
 	QStringList m_localHostNames;
 	QList<QHostAddress> m_localHostAddresses;
 
+	bool m_networkObjectsLoaded;
+
 };
@@ -242,7 +242,7 @@ void MainWindow::keyPressEvent( QKeyEvent* event )
 	switch( event->key() )
 	{
 	case Qt::Key_F5:
-		VeyonCore::networkObjectDirectoryManager().configuredDirectory()->update();
+		VeyonCore::networkObjectDirectoryManager().configuredDirectory()->updateInBackground();
 		m_master.computerControlListModel().reload();
 		event->accept();
 		break;
@@ -40,9 +40,12 @@ AuthKeysManager::AuthKeysManager( AuthKeysConfiguration& configuration, QObject*
 	m_configuration( configuration ),
 	m_keyTypePrivate( QStringLiteral("private") ),
 	m_keyTypePublic( QStringLiteral("public") ),
+	m_keyAlgorithmRsa( QStringLiteral("rsa") ),
+	m_keyAlgorithmEd25519( QStringLiteral("ed25519") ),
 	m_checkPermissions( tr( "Please check your permissions." ) ),
 	m_invalidKeyName( tr( "Key name contains invalid characters!" ) ),
 	m_invalidKeyType( tr( "Invalid key type specified! Please specify \"%1\" or \"%2\"." ).arg( m_keyTypePrivate, m_keyTypePublic ) ),
+	m_invalidKeyAlgorithm( tr( "Invalid key algorithm specified! Please specify \"%1\" or \"%2\"." ).arg( m_keyAlgorithmRsa, m_keyAlgorithmEd25519 ) ),
 	m_keyDoesNotExist( tr( "Specified key does not exist! Please use the \"list\" command to list all installed keys." ) ),
 	m_keysAlreadyExists( tr( "One or more key files already exist! Please delete them using the \"delete\" command." ) ),
 	m_resultMessage()
@@ -57,7 +60,7 @@ bool AuthKeysManager::isKeyNameValid( const QString& authKeyName )
 
 
 
-bool AuthKeysManager::createKeyPair( const QString& name )
+bool AuthKeysManager::createKeyPair( const QString& name, const QString& algorithm )
 {
 	if( isKeyNameValid( name ) == false)
 	{
@@ -65,6 +68,13 @@ bool AuthKeysManager::createKeyPair( const QString& name )
 		return false;
 	}
 
+	const auto keyAlgorithm = algorithm.isEmpty() ? m_keyAlgorithmRsa : algorithm.toLower();
+	if( keyAlgorithm != m_keyAlgorithmRsa && keyAlgorithm != m_keyAlgorithmEd25519 )
+	{
+		m_resultMessage = m_invalidKeyAlgorithm;
+		return false;
+	}
+
 	const auto privateKeyFileName = privateKeyPath( name );
 	const auto publicKeyFileName = publicKeyPath( name );
 
@@ -76,20 +86,42 @@ bool AuthKeysManager::createKeyPair( const QString& name )
 
 	CommandLineIO::print( tr( "Creating new key pair for \"%1\"" ).arg( name ) );
 
-	const auto privateKey = CryptoCore::KeyGenerator().createRSA( CryptoCore::RsaKeySize );
-	const auto publicKey = privateKey.toPublicKey();
-
-	if( privateKey.isNull() || publicKey.isNull() )
+	if( keyAlgorithm == m_keyAlgorithmEd25519 )
 	{
-		m_resultMessage = tr( "Failed to create public or private key!" );
-		return false;
-	}
+		const auto privateKey = CryptoCore::createEd25519PrivateKey();
+		const auto privateKeyPEM = CryptoCore::ed25519PrivateKeyToPEM( privateKey );
+		const auto publicKeyPEM = CryptoCore::ed25519PublicKeyToPEM( CryptoCore::ed25519PublicKey( privateKey ) );
 
-	if( writePrivateKeyFile( privateKey, privateKeyFileName ) == false ||
-			writePublicKeyFile( publicKey, publicKeyFileName ) == false )
+		if( privateKeyPEM.isEmpty() || publicKeyPEM.isEmpty() )
+		{
+			m_resultMessage = tr( "Failed to create public or private key!" );
+			return false;
+		}
+
+		if( writePrivateKeyData( privateKeyPEM, privateKeyFileName ) == false ||
+				writePublicKeyData( publicKeyPEM, publicKeyFileName ) == false )
+		{
+			// m_resultMessage already set by write functions
+			return false;
+		}
+	}
+	else
 	{
-		// m_resultMessage already set by write functions
-		return false;
+		const auto privateKey = CryptoCore::KeyGenerator().createRSA( CryptoCore::RsaKeySize );
+		const auto publicKey = privateKey.toPublicKey();
+
+		if( privateKey.isNull() || publicKey.isNull() )
+		{
+			m_resultMessage = tr( "Failed to create public or private key!" );
+			return false;
+		}
+
+		if( writePrivateKeyFile( privateKey, privateKeyFileName ) == false ||
+				writePublicKeyFile( publicKey, publicKeyFileName ) == false )
+		{
+			// m_resultMessage already set by write functions
+			return false;
+		}
 	}
 
 	m_resultMessage = tr( "Newly created key pair has been saved to \"%1\" and \"%2\"." ).arg( privateKeyFileName, publicKeyFileName );
@@ -180,36 +212,22 @@ bool AuthKeysManager::importKey( const QString& name, const QString& type, const
 		return false;
 	}
 
-	QString keyFileName;
-
-	if( type == m_keyTypePrivate )
+	if( type != m_keyTypePrivate && type != m_keyTypePublic )
 	{
-		const auto privateKey = CryptoCore::PrivateKey( inputFile );
-		if( privateKey.isNull() || privateKey.isPrivate() == false )
-		{
-			m_resultMessage = tr( "File \"%1\" does not contain a valid private key!" ).arg( inputFile );
-			return false;
-		}
-
-		keyFileName = privateKeyPath( name );
+		m_resultMessage = m_invalidKeyType;
+		return false;
 	}
-	else if( type == m_keyTypePublic )
-	{
-		const auto publicKey = CryptoCore::PublicKey( inputFile );
-		if( publicKey.isNull() || publicKey.isPublic() == false )
-		{
-			m_resultMessage = tr( "File \"%1\" does not contain a valid public key!" ).arg( inputFile );
-			return false;
-		}
 
-		keyFileName = publicKeyPath( name );
-	}
-	else
+	if( detectKeyType( inputFile ) != type )
 	{
-		m_resultMessage = m_invalidKeyType;
+		m_resultMessage = ( type == m_keyTypePrivate ?
+								tr( "File \"%1\" does not contain a valid private key!" ) :
+								tr( "File \"%1\" does not contain a valid public key!" ) ).arg( inputFile );
 		return false;
 	}
 
+	const auto keyFileName = keyFilePathFromType( name, type );
+
 	if( QFileInfo::exists( keyFileName ) )
 	{
 		m_resultMessage = m_keysAlreadyExists;
@@ -299,6 +317,19 @@ bool AuthKeysManager::extractPublicFromPrivateKey( const QString& name )
 		return false;
 	}
 
+	const auto ed25519PrivateKey = CryptoCore::ed25519PrivateKeyFromPEM( readKeyFile( privateKeyFileName ) );
+	if( ed25519PrivateKey.isEmpty() == false )
+	{
+		const auto publicKeyPEM = CryptoCore::ed25519PublicKeyToPEM( CryptoCore::ed25519PublicKey( ed25519PrivateKey ) );
+		if( publicKeyPEM.isEmpty() )
+		{
+			m_resultMessage = tr( "Failed to convert private key to public key" );
+			return false;
+		}
+
+		return writePublicKeyData( publicKeyPEM, publicKeyFileName );
+	}
+
 	const auto publicKey = CryptoCore::PrivateKey( privateKeyFileName ).toPublicKey();
 	if( publicKey.isNull() || publicKey.isPublic() == false )
 	{
@@ -312,6 +343,20 @@ bool AuthKeysManager::extractPublicFromPrivateKey( const QString& name )
 
 
 bool AuthKeysManager::writePrivateKeyFile( const CryptoCore::PrivateKey& privateKey, const QString& privateKeyFileName )
+{
+	return writePrivateKeyData( privateKey.toPEM().toUtf8(), privateKeyFileName );
+}
+
+
+
+bool AuthKeysManager::writePublicKeyFile( const CryptoCore::PublicKey& publicKey, const QString& publicKeyFileName )
+{
+	return writePublicKeyData( publicKey.toPEM().toUtf8(), publicKeyFileName );
+}
+
+
+
+bool AuthKeysManager::writePrivateKeyData( const QByteArray& pemData, const QString& privateKeyFileName )
 {
 	if( VeyonCore::filesystem().ensurePathExists( QFileInfo( privateKeyFileName ).path() ) == false )
 	{
@@ -319,7 +364,7 @@ bool AuthKeysManager::writePrivateKeyFile( const CryptoCore::PrivateKey& private
 		return false;
 	}
 
-	if( privateKey.toPEMFile( privateKeyFileName ) == false )
+	if( writeKeyFile( pemData, privateKeyFileName ) == false )
 	{
 		m_resultMessage = tr( "Failed to save private key in file \"%1\"!" ).arg( privateKeyFileName ) + QLatin1Char(' ') + m_checkPermissions;
 		return false;
@@ -336,7 +381,7 @@ bool AuthKeysManager::writePrivateKeyFile( const CryptoCore::PrivateKey& private
 
 
 
-bool AuthKeysManager::writePublicKeyFile( const CryptoCore::PublicKey& publicKey, const QString& publicKeyFileName )
+bool AuthKeysManager::writePublicKeyData( const QByteArray& pemData, const QString& publicKeyFileName )
 {
 	if(	VeyonCore::filesystem().ensurePathExists( QFileInfo( publicKeyFileName ).path() ) == false )
 	{
@@ -344,7 +389,7 @@ bool AuthKeysManager::writePublicKeyFile( const CryptoCore::PublicKey& publicKey
 		return false;
 	}
 
-	if( publicKey.toPEMFile( publicKeyFileName ) == false )
+	if( writeKeyFile( pemData, publicKeyFileName ) == false )
 	{
 		m_resultMessage = tr( "Failed to save public key in file \"%1\"!" ).arg( publicKeyFileName ) + QLatin1Char(' ') + m_checkPermissions;
 		return false;
@@ -363,6 +408,18 @@ bool AuthKeysManager::writePublicKeyFile( const CryptoCore::PublicKey& publicKey
 
 QString AuthKeysManager::detectKeyType( const QString& keyFile )
 {
+	const auto keyData = readKeyFile( keyFile );
+
+	if( CryptoCore::ed25519PrivateKeyFromPEM( keyData ).isEmpty() == false )
+	{
+		return m_keyTypePrivate;
+	}
+
+	if( CryptoCore::ed25519PublicKeyFromPEM( keyData ).isEmpty() == false )
+	{
+		return m_keyTypePublic;
+	}
+
 	const auto privateKey = CryptoCore::PrivateKey( keyFile );
 	if( privateKey.isNull() == false && privateKey.isPrivate()  )
 	{
@@ -442,6 +499,19 @@ QString AuthKeysManager::keyPairId( const QString& key )
 	}
 
 	const auto keyFileName = keyFilePathFromType( name, type );
+	const auto keyData = readKeyFile( keyFileName );
+
+	const auto ed25519PrivateKey = CryptoCore::ed25519PrivateKeyFromPEM( keyData );
+	if( ed25519PrivateKey.isEmpty() == false )
+	{
+		return QStringLiteral("%1").arg( qHash( CryptoCore::ed25519PublicKey( ed25519PrivateKey ) ), 8, 16, QLatin1Char('0') );
+	}
+
+	const auto ed25519PublicKey = CryptoCore::ed25519PublicKeyFromPEM( keyData );
+	if( ed25519PublicKey.isEmpty() == false )
+	{
+		return QStringLiteral("%1").arg( qHash( ed25519PublicKey ), 8, 16, QLatin1Char('0') );
+	}
 
 	const auto privateKey = CryptoCore::PrivateKey( keyFileName );
 	if( privateKey.isNull() == false && privateKey.isPrivate()  )
@@ -460,6 +530,50 @@ QString AuthKeysManager::keyPairId( const QString& key )
 
 
 
+QString AuthKeysManager::keyAlgorithm( const QString& key )
+{
+	const auto nameAndType = key.split( QLatin1Char('/') );
+	const auto name = nameAndType.value( 0 );
+	const auto type = nameAndType.value( 1 );
+
+	if( checkKey( name, type ) == false )
+	{
+		return tr("<N/A>");
+	}
+
+	const auto keyFileName = keyFilePathFromType( name, type );
+	const auto keyData = readKeyFile( keyFileName );
+
+	if( CryptoCore::ed25519PrivateKeyFromPEM( keyData ).isEmpty() == false ||
+		CryptoCore::ed25519PublicKeyFromPEM( keyData ).isEmpty() == false )
+	{
+		return m_keyAlgorithmEd25519;
+	}
+
+	if( CryptoCore::PrivateKey( keyFileName ).isNull() == false ||
+		CryptoCore::PublicKey( keyFileName ).isNull() == false )
+	{
+		return m_keyAlgorithmRsa;
+	}
+
+	return QStringLiteral("???");
+}
+
+
+
+QByteArray AuthKeysManager::readKeyFile( const QString& keyFile )
+{
+	QFile file( keyFile );
+	if( file.open( QFile::ReadOnly ) == false )
+	{
+		return {};
+	}
+
+	return file.readAll();
+}
+
+
+
 QString AuthKeysManager::exportedKeyFileName( const QString& name, const QString& type )
 {
 	return QStringLiteral("%1_%2_key.pem").arg( name, type );
@@ -581,3 +695,13 @@ bool AuthKeysManager::setPublicKeyFilePermissions( const QString& fileName ) con
 {
 	return QFile::setPermissions( fileName, QFile::ReadOwner | QFile::ReadUser | QFile::ReadGroup | QFile::ReadOther );
 }
+
+
+
+bool AuthKeysManager::writeKeyFile( const QByteArray& pemData, const QString& keyFileName )
+{
+	QFile keyFile( keyFileName );
+
+	return keyFile.open( QFile::WriteOnly | QFile::Truncate ) &&
+			keyFile.write( pemData ) == pemData.size();
+}
@@ -42,7 +42,7 @@ public:
 		return m_resultMessage;
 	}
 
-	bool createKeyPair( const QString& name );
+	bool createKeyPair( const QString& name, const QString& algorithm = {} );
 	bool deleteKey( const QString& name, const QString& type );
 	bool exportKey( const QString& name, const QString& type, const QString& outputFile );
 	bool importKey( const QString& name, const QString& type, const QString& inputFile );
@@ -58,6 +58,9 @@ public:
 	QString accessGroup( const QString& key );
 
 	QString keyPairId( const QString& key );
+	QString keyAlgorithm( const QString& key );
+
+	static QByteArray readKeyFile( const QString& keyFile );
 
 	static QString exportedKeyFileName( const QString& name, const QString& type );
 	static QString keyNameFromExportedKeyFile( const QString& keyFile );
@@ -68,6 +71,10 @@ public:
 private:
 	bool checkKey( const QString& name, const QString& type, bool checkIsReadable = true );
 
+	bool writePrivateKeyData( const QByteArray& pemData, const QString& privateKeyFileName );
+	bool writePublicKeyData( const QByteArray& pemData, const QString& publicKeyFileName );
+	static bool writeKeyFile( const QByteArray& pemData, const QString& keyFileName );
+
 	QString keyFilePathFromType( const QString& name, const QString& type ) const;
 	bool setKeyFilePermissions( const QString& name, const QString& type ) const;
 	bool setPrivateKeyFilePermissions( const QString& fileName ) const;
@@ -76,9 +83,12 @@ private:
 	AuthKeysConfiguration& m_configuration;
 	const QString m_keyTypePrivate;
 	const QString m_keyTypePublic;
+	const QString m_keyAlgorithmRsa;
+	const QString m_keyAlgorithmEd25519;
 	const QString m_checkPermissions;
 	const QString m_invalidKeyName;
 	const QString m_invalidKeyType;
+	const QString m_invalidKeyAlgorithm;
 	const QString m_keyDoesNotExist;
 	const QString m_keysAlreadyExists;
 	QString m_resultMessage;
@@ -24,6 +24,7 @@
 
 #include <QApplication>
 #include <QDir>
+#include <QFileInfo>
 #include <QMessageBox>
 #include <QProcessEnvironment>
 
@@ -40,6 +41,9 @@ AuthKeysPlugin::AuthKeysPlugin( QObject* parent ) :
 	m_configuration( &VeyonCore::config() ),
 	m_manager( m_configuration ),
 	m_privateKey(),
+	m_ed25519PrivateKey(),
+	m_publicKeyCacheMutex(),
+	m_publicKeyCache(),
 	m_commands( {
 { QStringLiteral("create"), tr( "Create new authentication key pair" ) },
 { QStringLiteral("delete"), tr( "Delete authentication key" ) },
@@ -68,6 +72,7 @@ void AuthKeysPlugin::upgrade(const QVersionNumber& oldVersion)
 bool AuthKeysPlugin::initializeCredentials()
 {
 	m_privateKey = {};
+	m_ed25519PrivateKey.clear();
 
 	auto authKeyName = QProcessEnvironment::systemEnvironment().value( QStringLiteral("VEYON_AUTH_KEY_NAME") );
 
@@ -103,7 +108,7 @@ bool AuthKeysPlugin::initializeCredentials()
 
 bool AuthKeysPlugin::hasCredentials() const
 {
-	return m_privateKey.isNull() == false;
+	return m_privateKey.isNull() == false || m_ed25519PrivateKey.isEmpty() == false;
 }
 
 
@@ -163,13 +168,7 @@ VncServerClient::AuthState AuthKeysPlugin::performAuthentication( VncServerClien
 		// under which the client claims to run
 		const auto signature = message.read().toByteArray(); // Flawfinder: ignore
 
-		const auto publicKeyPath = m_manager.publicKeyPath( authKeyName );
-
-		vDebug() << "loading public key" << publicKeyPath;
-		CryptoCore::PublicKey publicKey( publicKeyPath );
-
-		if( publicKey.isNull() || publicKey.isPublic() == false ||
-			publicKey.verifyMessage( client->challenge(), signature, CryptoCore::DefaultSignatureAlgorithm ) == false )
+		if( verifySignature( m_manager.publicKeyPath( authKeyName ), client->challenge(), signature ) == false )
 		{
 			vWarning() << "FAIL";
 			return VncServerClient::AuthState::Failed;
@@ -200,16 +199,31 @@ bool AuthKeysPlugin::authenticate( QIODevice* socket ) const
 		return false;
 	}
 
-	// create local copy of private key so we can modify it within our own thread
-	auto key = m_privateKey;
+	QByteArray signature;
 
-	if( key.isNull() || key.canSign() == false )
+	if( m_ed25519PrivateKey.isEmpty() == false )
 	{
-		vCritical() << QThread::currentThreadId() << "invalid private key!";
-		return false;
+		signature = CryptoCore::signEd25519( m_ed25519PrivateKey, challenge );
+	}
+	else
+	{
+		// create local copy of private key so we can modify it within our own thread
+		auto key = m_privateKey;
+
+		if( key.isNull() || key.canSign() == false )
+		{
+			vCritical() << QThread::currentThreadId() << "invalid private key!";
+			return false;
+		}
+
+		signature = key.signMessage( challenge, CryptoCore::DefaultSignatureAlgorithm );
 	}
 
-	const auto signature = key.signMessage( challenge, CryptoCore::DefaultSignatureAlgorithm );
+	if( signature.isEmpty() )
+	{
+		vCritical() << QThread::currentThreadId() << "failed to sign challenge!";
+		return false;
+	}
 
 	VariantArrayMessage challengeResponseMessage( socket );
 	challengeResponseMessage.write( m_authKeyName );
@@ -241,10 +255,12 @@ CommandLinePluginInterface::RunResult AuthKeysPlugin::handle_help( const QString
 
 	const QMap<QString, QStringList> commands = {
 		{ QStringLiteral("create"),
-		  QStringList( { QStringLiteral("<%1>").arg( tr("NAME") ),
+		  QStringList( { QStringLiteral("<%1> [<%2>]").arg( tr("NAME"), tr("ALGORITHM") ),
 						 tr( "This command creates a new authentication key pair with name <NAME> and saves private and "
 						 "public key to the configured key directories. The parameter must be a name for the key, which "
-						 "may only contain letters." ) } ) },
+						 "may only contain letters. The optional parameter <ALGORITHM> may be \"%1\" (default) or "
+						 "\"%2\". Ed25519 keys are considerably faster to sign and verify." ).
+						 arg( QLatin1String("rsa"), QLatin1String("ed25519") ) } ) },
 		{ QStringLiteral("delete"),
 		  QStringList( { QStringLiteral("<%1>").arg( tr("KEY") ),
 						 tr( "This command deletes the authentication key <KEY> from the configured key directory. "
@@ -319,7 +335,7 @@ CommandLinePluginInterface::RunResult AuthKeysPlugin::handle_create( const QStri
 		return NotEnoughArguments;
 	}
 
-	if( m_manager.createKeyPair( arguments.first() ) == false )
+	if( m_manager.createKeyPair( arguments.first(), arguments.value( 1 ) ) == false )
 	{
 		error( m_manager.resultMessage() );
 
@@ -468,6 +484,12 @@ bool AuthKeysPlugin::loadPrivateKey( const QString& privateKeyFile )
 		return false;
 	}
 
+	m_ed25519PrivateKey = CryptoCore::ed25519PrivateKeyFromPEM( AuthKeysManager::readKeyFile( privateKeyFile ) );
+	if( m_ed25519PrivateKey.isEmpty() == false )
+	{
+		return true;
+	}
+
 	m_privateKey = CryptoCore::PrivateKey( privateKeyFile );
 
 	return m_privateKey.isNull() == false && m_privateKey.isPrivate();
@@ -475,12 +497,60 @@ bool AuthKeysPlugin::loadPrivateKey( const QString& privateKeyFile )
 
 
 
+bool AuthKeysPlugin::verifySignature( const QString& publicKeyFile, const QByteArray& message, const QByteArray& signature ) const
+{
+	const QFileInfo publicKeyFileInfo( publicKeyFile );
+	if( publicKeyFileInfo.exists() == false )
+	{
+		vWarning() << "public key file" << publicKeyFile << "does not exist";
+		return false;
+	}
+
+	QMutexLocker locker( &m_publicKeyCacheMutex );
+
+	auto cachedKey = m_publicKeyCache.find( publicKeyFile );
+	if( cachedKey == m_publicKeyCache.end() ||
+		cachedKey->lastModified != publicKeyFileInfo.lastModified() ||
+		cachedKey->size != publicKeyFileInfo.size() )
+	{
+		vDebug() << "loading public key" << publicKeyFile;
+
+		CachedPublicKey publicKey{ publicKeyFileInfo.lastModified(), publicKeyFileInfo.size(), {},
+								   CryptoCore::ed25519PublicKeyFromPEM( AuthKeysManager::readKeyFile( publicKeyFile ) ) };
+
+		if( publicKey.ed25519Key.isEmpty() )
+		{
+			publicKey.rsaKey = CryptoCore::PublicKey( publicKeyFile );
+			if( publicKey.rsaKey.isNull() || publicKey.rsaKey.isPublic() == false )
+			{
+				vWarning() << "invalid public key" << publicKeyFile;
+				m_publicKeyCache.remove( publicKeyFile );
+				return false;
+			}
+		}
+
+		cachedKey = m_publicKeyCache.insert( publicKeyFile, publicKey );
+	}
+
+	if( cachedKey->ed25519Key.isEmpty() == false )
+	{
+		return CryptoCore::verifyEd25519( cachedKey->ed25519Key, message, signature );
+	}
+
+	// create local copy as verifying modifies key state
+	auto rsaKey = cachedKey->rsaKey;
+
+	return rsaKey.verifyMessage( message, signature, CryptoCore::DefaultSignatureAlgorithm );
+}
+
+
+
 void AuthKeysPlugin::printAuthKeyTable()
 {
 	AuthKeysTableModel tableModel( m_manager );
 	tableModel.reload();
 
-	TableHeader tableHeader( { tr("NAME"), tr("TYPE"), tr("PAIR ID"), tr("ACCESS GROUP") } );
+	TableHeader tableHeader( { tr("NAME"), tr("TYPE"), tr("ALGORITHM"), tr("PAIR ID"), tr("ACCESS GROUP") } );
 	TableRows tableRows;
 
 	tableRows.reserve( tableModel.rowCount() );
@@ -489,6 +559,7 @@ void AuthKeysPlugin::printAuthKeyTable()
 	{
 		tableRows.append( { authKeysTableData( tableModel, i, AuthKeysTableModel::ColumnKeyName ),
 							authKeysTableData( tableModel, i, AuthKeysTableModel::ColumnKeyType ),
+							authKeysTableData( tableModel, i, AuthKeysTableModel::ColumnKeyAlgorithm ),
 							authKeysTableData( tableModel, i, AuthKeysTableModel::ColumnKeyPairID ),
 							authKeysTableData( tableModel, i, AuthKeysTableModel::ColumnAccessGroup ) } );
 	}
@@ -24,6 +24,9 @@
 
 #pragma once
 
+#include <QDateTime>
+#include <QMutex>
+
 #include "AuthenticationPluginInterface.h"
 #include "AuthKeysConfiguration.h"
 #include "AuthKeysManager.h"
@@ -120,7 +123,16 @@ public slots:
 	CommandLinePluginInterface::RunResult handle_extract( const QStringList& arguments );
 
 private:
+	struct CachedPublicKey
+	{
+		QDateTime lastModified;
+		qint64 size;
+		CryptoCore::PublicKey rsaKey;
+		QByteArray ed25519Key;
+	};
+
 	bool loadPrivateKey( const QString& privateKeyFile );
+	bool verifySignature( const QString& publicKeyFile, const QByteArray& message, const QByteArray& signature ) const;
 
 	void printAuthKeyTable();
 	static QString authKeysTableData( const AuthKeysTableModel& tableModel, int row, int column );
@@ -130,8 +142,13 @@ private:
 	AuthKeysManager m_manager;
 
 	CryptoCore::PrivateKey m_privateKey;
+	CryptoCore::SecureArray m_ed25519PrivateKey;
 	QString m_authKeyName;
 
+	// parsed public keys, reloaded whenever the key file changes
+	mutable QMutex m_publicKeyCacheMutex;
+	mutable QHash<QString, CachedPublicKey> m_publicKeyCache;
+
 	QMap<QString, QString> m_commands;
 
 };
@@ -76,6 +76,7 @@ QVariant AuthKeysTableModel::data( const QModelIndex& index, int role ) const
 	{
 	case ColumnKeyName: return key.split( QLatin1Char('/') ).value( 0 );
 	case ColumnKeyType: return key.split( QLatin1Char('/') ).value( 1 );
+	case ColumnKeyAlgorithm: return m_manager.keyAlgorithm( key );
 	case ColumnAccessGroup: return m_manager.accessGroup( key );
 	case ColumnKeyPairID: return m_manager.keyPairId( key );
 	default: break;
@@ -97,6 +98,7 @@ QVariant AuthKeysTableModel::headerData( int section, Qt::Orientation orientatio
 	{
 	case ColumnKeyName: return tr( "Name" );
 	case ColumnKeyType: return tr( "Type" );
+	case ColumnKeyAlgorithm: return tr( "Algorithm" );
 	case ColumnAccessGroup: return tr( "Access group");
 	case ColumnKeyPairID: return tr( "Pair ID");
 	default:
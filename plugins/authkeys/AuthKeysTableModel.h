@@ -35,6 +35,7 @@ public:
 	enum Columns {
 		ColumnKeyName,
 		ColumnKeyType,
+		ColumnKeyAlgorithm,
 		ColumnKeyPairID,
 		ColumnAccessGroup,
 		ColumnCount
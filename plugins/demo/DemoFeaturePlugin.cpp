@@ -23,6 +23,7 @@
  */
 
 #include <QCoreApplication>
+#include <QTcpSocket>
 
 #include "AuthenticationCredentials.h"
 #include "Computer.h"
@@ -0,0 +1,207 @@
+/*
+ * ArchiveReader.cpp - implementation of ArchiveReader class
+ *
+ * Copyright (c) 2018-2019 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDirIterator>
+
+#include <algorithm>
+
+#include "ArchiveReader.h"
+#include "VeyonCore.h"
+
+
+ArchiveReader::ArchiveReader( const QString& directory ) :
+	m_directory( directory ),
+	m_entries(),
+	m_archiveSize( 0 ),
+	m_archivePos( 0 ),
+	m_currentFile()
+{
+}
+
+
+
+bool ArchiveReader::open()
+{
+	if( m_directory.exists() == false || m_directory.isReadable() == false )
+	{
+		return false;
+	}
+
+	m_entries.clear();
+
+	// collect all entries upfront so the total archive size is known at the beginning of the transfer
+	QDirIterator it( m_directory.absolutePath(), QDir::AllEntries | QDir::Hidden | QDir::NoDotAndDotDot,
+					 QDirIterator::Subdirectories );
+	while( it.hasNext() )
+	{
+		it.next();
+		const auto fileInfo = it.fileInfo();
+
+		if( fileInfo.isSymLink() )
+		{
+			continue;
+		}
+
+		const auto relativePath = m_directory.relativeFilePath( fileInfo.absoluteFilePath() );
+		const auto lastModified = fileInfo.lastModified().toMSecsSinceEpoch();
+
+		if( fileInfo.isDir() )
+		{
+			m_entries.append( { fileInfo.absoluteFilePath(),
+								entryHeader( DirectoryEntry, relativePath, lastModified, 0 ), 0, 0 } );
+		}
+		else if( fileInfo.isFile() )
+		{
+			m_entries.append( { fileInfo.absoluteFilePath(),
+								entryHeader( FileEntry, relativePath, lastModified, fileInfo.size() ),
+								fileInfo.size(), 0 } );
+		}
+	}
+
+	m_entries.append( { {}, entryHeader( EndOfArchive, {}, 0, 0 ), 0, 0 } );
+
+	m_archiveSize = 0;
+	for( auto& entry : m_entries )
+	{
+		entry.offset = m_archiveSize;
+		m_archiveSize += entry.header.size() + entry.size;
+	}
+
+	m_archivePos = 0;
+
+	return true;
+}
+
+
+
+QByteArray ArchiveReader::readChunk( qint64 chunkSize )
+{
+	const auto chunk = readChunkAt( m_archivePos, chunkSize );
+	m_archivePos += chunk.size();
+
+	return chunk;
+}
+
+
+
+QByteArray ArchiveReader::readChunkAt( qint64 pos, qint64 chunkSize )
+{
+	QByteArray chunk;
+	chunk.reserve( static_cast<int>( qBound<qint64>( 0, m_archiveSize - pos, chunkSize ) ) );
+
+	// look up entry containing the requested position
+	auto entry = std::upper_bound( m_entries.cbegin(), m_entries.cend(), pos,
+								   []( qint64 value, const Entry& e ) { return value < e.offset; } );
+	if( entry == m_entries.cbegin() )
+	{
+		return chunk;
+	}
+	--entry;
+
+	// pack as many entries as possible into one chunk
+	while( chunk.size() < chunkSize && entry != m_entries.cend() )
+	{
+		const auto entryPos = pos + chunk.size() - entry->offset;
+		const auto headerSize = entry->header.size();
+
+		if( entryPos < headerSize )
+		{
+			const auto count = qMin<qint64>( headerSize - entryPos, chunkSize - chunk.size() );
+			chunk.append( entry->header.constData() + entryPos, static_cast<int>( count ) );
+		}
+		else if( entryPos < headerSize + entry->size )
+		{
+			readEntryData( chunk, *entry, entryPos - headerSize, chunkSize - chunk.size() );
+		}
+		else
+		{
+			++entry;
+		}
+	}
+
+	return chunk;
+}
+
+
+
+qint64 ArchiveReader::size() const
+{
+	return m_archiveSize;
+}
+
+
+
+bool ArchiveReader::atEnd() const
+{
+	return m_archivePos >= m_archiveSize;
+}
+
+
+
+int ArchiveReader::progress() const
+{
+	return m_archiveSize > 0 ? static_cast<int>( m_archivePos * 100 / m_archiveSize ) : 0;
+}
+
+
+
+QByteArray ArchiveReader::entryHeader( EntryType type, const QString& relativePath, qint64 lastModified, qint64 size )
+{
+	QByteArray header;
+	QDataStream stream( &header, QIODevice::WriteOnly );
+	stream.setVersion( QDataStream::Qt_5_5 );
+	stream << static_cast<quint8>( type ) << relativePath << lastModified << size;
+
+	return header;
+}
+
+
+
+void ArchiveReader::readEntryData( QByteArray& chunk, const Entry& entry, qint64 dataPos, qint64 maximumSize )
+{
+	const auto count = qMin( entry.size - dataPos, maximumSize );
+
+	// keep file open as usually subsequent chunks are read from the same file
+	if( m_currentFile.fileName() != entry.absolutePath || m_currentFile.isOpen() == false )
+	{
+		m_currentFile.close();
+		m_currentFile.setFileName( entry.absolutePath );
+		if( m_currentFile.open( QFile::ReadOnly ) == false )
+		{
+			vWarning() << "could not open" << entry.absolutePath;
+		}
+	}
+
+	auto data = m_currentFile.isOpen() && m_currentFile.seek( dataPos ) ? m_currentFile.read( count ) : QByteArray();
+
+	// the announced size has to be kept even if the file has been truncated or become unreadable meanwhile
+	if( data.size() < count )
+	{
+		data.append( QByteArray( static_cast<int>( count - data.size() ), 0 ) );
+	}
+
+	chunk.append( data );
+}
@@ -0,0 +1,76 @@
+/*
+ * ArchiveReader.h - declaration of ArchiveReader class
+ *
+ * Copyright (c) 2018-2019 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <QDir>
+#include <QFile>
+
+#include "ChunkReader.h"
+
+// serializes a directory tree into a stream of framed entries (header followed
+// by file data) which can be unpacked on the fly by ArchiveWriter
+class ArchiveReader : public ChunkReader
+{
+public:
+	enum EntryType {
+		EndOfArchive,
+		DirectoryEntry,
+		FileEntry
+	};
+
+	explicit ArchiveReader( const QString& directory );
+	~ArchiveReader() override = default;
+
+	bool open() override;
+
+	QByteArray readChunk( qint64 chunkSize ) override;
+	QByteArray readChunkAt( qint64 pos, qint64 chunkSize ) override;
+
+	qint64 size() const override;
+	bool atEnd() const override;
+	int progress() const override;
+
+	static QByteArray entryHeader( EntryType type, const QString& relativePath, qint64 lastModified, qint64 size );
+
+private:
+	struct Entry
+	{
+		QString absolutePath;
+		QByteArray header;
+		qint64 size;
+		qint64 offset; // position of header within archive
+	};
+
+	void readEntryData( QByteArray& chunk, const Entry& entry, qint64 dataPos, qint64 maximumSize );
+
+	const QDir m_directory;
+
+	QList<Entry> m_entries;
+	qint64 m_archiveSize;
+	qint64 m_archivePos;
+
+	QFile m_currentFile;
+
+};
@@ -0,0 +1,278 @@
+/*
+ * ArchiveWriter.cpp - implementation of ArchiveWriter class
+ *
+ * Copyright (c) 2018-2019 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <QDataStream>
+#include <QDateTime>
+
+#include "ArchiveReader.h"
+#include "ArchiveWriter.h"
+#include "VeyonCore.h"
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
+
+
+ArchiveWriter::ArchiveWriter( const QString& directory, bool overwriteExistingFiles ) :
+	m_directory( directory ),
+	m_overwriteExistingFiles( overwriteExistingFiles ),
+	m_buffer(),
+	m_currentFile(),
+	m_currentFileRemaining( 0 ),
+	m_currentFileLastModified( 0 ),
+	m_directoryTimes(),
+	m_complete( false ),
+	m_skippedFiles( 0 )
+{
+	m_directory.mkpath( QStringLiteral(".") );
+}
+
+
+
+ArchiveWriter::~ArchiveWriter()
+{
+	closeCurrentFile();
+}
+
+
+
+bool ArchiveWriter::write( const QByteArray& data )
+{
+	// only buffer data if a header has been split across chunks
+	const auto input = m_buffer.isEmpty() ? data : m_buffer + data;
+	m_buffer.clear();
+
+	qint64 pos = 0;
+	const qint64 size = input.size();
+
+	while( pos < size )
+	{
+		if( m_currentFileRemaining > 0 )
+		{
+			const auto count = qMin( m_currentFileRemaining, size - pos );
+			if( m_currentFile.isOpen() &&
+				m_currentFile.write( input.constData() + pos, count ) != count )
+			{
+				vWarning() << "could not write" << m_currentFile.fileName() << m_currentFile.errorString();
+				return false;
+			}
+			pos += count;
+			m_currentFileRemaining -= count;
+
+			if( m_currentFileRemaining <= 0 && closeCurrentFile() == false )
+			{
+				return false;
+			}
+			continue;
+		}
+
+		if( m_complete )
+		{
+			vWarning() << "trailing data after end of archive";
+			return false;
+		}
+
+		const auto headerSize = processHeader( input.constData() + pos, size - pos );
+		if( headerSize < 0 )
+		{
+			return false;
+		}
+		if( headerSize == 0 )
+		{
+			if( size - pos > MaximumHeaderSize )
+			{
+				vWarning() << "invalid entry header";
+				return false;
+			}
+
+			// wait for remaining header data
+			m_buffer = input.mid( static_cast<int>( pos ) );
+			break;
+		}
+
+		pos += headerSize;
+	}
+
+	return true;
+}
+
+
+
+bool ArchiveWriter::finish()
+{
+	const auto flushed = closeCurrentFile();
+
+#ifdef Q_OS_LINUX
+	// restore modification times of directories after all their contents have been written
+	for( const auto& directoryTime : qAsConst(m_directoryTimes) )
+	{
+		const struct timespec times[2] = {
+			{ 0, UTIME_OMIT },
+			{ directoryTime.second / 1000, ( directoryTime.second % 1000 ) * 1000000 }
+		};
+		utimensat( AT_FDCWD, directoryTime.first.toUtf8().constData(), times, 0 );
+	}
+#endif
+
+	return flushed && m_complete;
+}
+
+
+
+void ArchiveWriter::abort()
+{
+	// remove incomplete file
+	if( m_currentFile.isOpen() )
+	{
+		m_currentFile.remove();
+	}
+
+	m_currentFileRemaining = 0;
+}
+
+
+
+qint64 ArchiveWriter::processHeader( const char* data, qint64 size )
+{
+	const auto header = QByteArray::fromRawData( data, static_cast<int>( size ) );
+	QDataStream stream( header );
+	stream.setVersion( QDataStream::Qt_5_5 );
+
+	quint8 type = 0;
+	QString relativePath;
+	qint64 lastModified = 0;
+	qint64 entrySize = 0;
+
+	stream >> type >> relativePath >> lastModified >> entrySize;
+
+	if( stream.status() == QDataStream::ReadPastEnd )
+	{
+		return 0;
+	}
+
+	if( stream.status() != QDataStream::Ok || entrySize < 0 )
+	{
+		vWarning() << "invalid entry header";
+		return -1;
+	}
+
+	const auto headerSize = stream.device()->pos();
+
+	if( type == ArchiveReader::EndOfArchive )
+	{
+		m_complete = true;
+		return headerSize;
+	}
+
+	const auto path = targetPath( relativePath );
+	if( path.isEmpty() )
+	{
+		vWarning() << "invalid path" << relativePath;
+		return -1;
+	}
+
+	switch( type )
+	{
+	case ArchiveReader::DirectoryEntry:
+		m_directory.mkpath( path );
+		m_directoryTimes.append( qMakePair( path, lastModified ) );
+		break;
+
+	case ArchiveReader::FileEntry:
+		m_currentFile.setFileName( path );
+		m_currentFileRemaining = entrySize;
+		m_currentFileLastModified = lastModified;
+
+		if( m_currentFile.exists() && m_overwriteExistingFiles == false )
+		{
+			// consume data without writing it
+			++m_skippedFiles;
+			break;
+		}
+
+		m_directory.mkpath( QFileInfo( path ).absolutePath() );
+		if( m_currentFile.open( QFile::WriteOnly | QFile::Truncate ) == false )
+		{
+			vWarning() << "could not open" << path << "for writing";
+			++m_skippedFiles;
+			break;
+		}
+
+		if( entrySize == 0 && closeCurrentFile() == false )
+		{
+			return -1;
+		}
+		break;
+
+	default:
+		vWarning() << "invalid entry type" << type;
+		return -1;
+	}
+
+	return headerSize;
+}
+
+
+
+QString ArchiveWriter::targetPath( const QString& relativePath ) const
+{
+	const auto cleanPath = QDir::cleanPath( relativePath );
+
+	// reject any paths which would end up outside of the target directory
+	if( cleanPath.isEmpty() ||
+		QDir::isAbsolutePath( cleanPath ) ||
+		cleanPath.contains( QLatin1Char(':') ) ||
+		cleanPath == QLatin1String("..") ||
+		cleanPath.startsWith( QLatin1String("../") ) )
+	{
+		return {};
+	}
+
+	return m_directory.absoluteFilePath( cleanPath );
+}
+
+
+
+bool ArchiveWriter::closeCurrentFile()
+{
+	if( m_currentFile.isOpen() == false )
+	{
+		return true;
+	}
+
+	if( m_currentFile.flush() == false )
+	{
+		vWarning() << "could not flush" << m_currentFile.fileName() << m_currentFile.errorString();
+		// do not leave a truncated file behind
+		m_currentFile.remove();
+		return false;
+	}
+
+	m_currentFile.setFileTime( QDateTime::fromMSecsSinceEpoch( m_currentFileLastModified ),
+							   QFileDevice::FileModificationTime );
+	m_currentFile.close();
+
+	return true;
+}
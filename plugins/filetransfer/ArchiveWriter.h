@@ -0,0 +1,71 @@
+/*
+ * ArchiveWriter.h - declaration of ArchiveWriter class
+ *
+ * Copyright (c) 2018-2019 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <QDir>
+#include <QFile>
+
+// unpacks a stream of entries generated by ArchiveReader into a directory while data is being received
+class ArchiveWriter
+{
+public:
+	ArchiveWriter( const QString& directory, bool overwriteExistingFiles );
+	~ArchiveWriter();
+
+	bool write( const QByteArray& data );
+	bool finish();
+	void abort();
+
+	QString directory() const
+	{
+		return m_directory.absolutePath();
+	}
+
+	int skippedFiles() const
+	{
+		return m_skippedFiles;
+	}
+
+private:
+	qint64 processHeader( const char* data, qint64 size );
+	QString targetPath( const QString& relativePath ) const;
+	bool closeCurrentFile();
+
+	static constexpr int MaximumHeaderSize = 64*1024;
+
+	const QDir m_directory;
+	const bool m_overwriteExistingFiles;
+
+	QByteArray m_buffer;
+
+	QFile m_currentFile;
+	qint64 m_currentFileRemaining;
+	qint64 m_currentFileLastModified;
+
+	QList<QPair<QString, qint64> > m_directoryTimes;
+	bool m_complete;
+	int m_skippedFiles;
+
+};
@@ -1,5 +1,5 @@
 /*
- * FileReadThread.h - declaration of FileReadThread class
+ * ChunkReader.h - declaration of ChunkReader interface
  *
  * Copyright (c) 2018-2019 Tobias Junghans <tobydox@veyon.io>
  *
@@ -24,38 +24,23 @@
 
 #pragma once
 
-#include <QFile>
-#include <QMutex>
-#include <QTimer>
-#include <QThread>
+#include <QByteArray>
 
-class FileReadThread : public QObject
+// interface for sources of data to be transferred in chunks
+class ChunkReader
 {
-	Q_OBJECT
 public:
-	explicit FileReadThread( const QString& fileName, QObject* parent = nullptr );
-	~FileReadThread() override;
+	virtual ~ChunkReader() = default;
 
-	bool start();
+	virtual bool open() = 0;
 
-	QByteArray currentChunk();
-	void readNextChunk( qint64 chunkSize );
-	bool isChunkReady();
+	virtual QByteArray readChunk( qint64 chunkSize ) = 0;
 
-	bool atEnd();
-	int progress();
+	// reads chunk at given position without affecting subsequent calls of readChunk()
+	virtual QByteArray readChunkAt( qint64 pos, qint64 chunkSize ) = 0;
 
-private:
-	QMutex m_mutex;
-	QThread* m_thread;
-	QFile* m_file;
-	QByteArray m_currentChunk;
-
-	QTimer* m_timer;
-
-	QString m_fileName;
-	bool m_chunkReady;
-	qint64 m_filePos;
-	qint64 m_fileSize;
+	virtual qint64 size() const = 0;
+	virtual bool atEnd() const = 0;
+	virtual int progress() const = 0;
 
 };
@@ -0,0 +1,143 @@
+/*
+ * FileReader.cpp - implementation of FileReader class
+ *
+ * Copyright (c) 2018-2019 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "FileReader.h"
+#include "VeyonCore.h"
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#endif
+
+
+FileReader::FileReader( const QString& fileName ) :
+	m_file( fileName ),
+	m_fileSize( 0 ),
+	m_filePos( 0 ),
+	m_prefetchPos( 0 )
+{
+}
+
+
+
+bool FileReader::open()
+{
+	// chunks are read into their own buffers directly so skip QFile's internal buffer
+	if( m_file.open( QFile::ReadOnly | QFile::Unbuffered ) == false )
+	{
+		return false;
+	}
+
+	m_fileSize = m_file.size();
+
+#ifdef Q_OS_LINUX
+	posix_fadvise( m_file.handle(), 0, 0, POSIX_FADV_SEQUENTIAL );
+#endif
+
+	prefetch();
+
+	return true;
+}
+
+
+
+QByteArray FileReader::readChunk( qint64 chunkSize )
+{
+	const auto chunk = readChunkAt( m_filePos, chunkSize );
+	m_filePos += chunk.size();
+
+	prefetch();
+
+	return chunk;
+}
+
+
+
+QByteArray FileReader::readChunkAt( qint64 pos, qint64 chunkSize )
+{
+	const auto size = qMin( chunkSize, m_fileSize - pos );
+	if( size <= 0 )
+	{
+		return {};
+	}
+
+	QByteArray data( static_cast<int>( size ), 0 );
+
+	qint64 bytesRead = -1;
+	if( m_file.seek( pos ) )
+	{
+		bytesRead = m_file.read( data.data(), size );
+	}
+
+	// the announced size has to be kept even if the file has been truncated or become unreadable
+	// meanwhile so the remaining data stays zero-filled
+	if( bytesRead < size )
+	{
+		vWarning() << "could only read" << bytesRead << "of" << size << "bytes at position" << pos
+				   << "from" << m_file.fileName();
+	}
+
+	return data;
+}
+
+
+
+qint64 FileReader::size() const
+{
+	return m_fileSize;
+}
+
+
+
+bool FileReader::atEnd() const
+{
+	return m_filePos >= m_fileSize;
+}
+
+
+
+int FileReader::progress() const
+{
+	return m_fileSize > 0 ? static_cast<int>( m_filePos * 100 / m_fileSize ) : 0;
+}
+
+
+
+void FileReader::prefetch()
+{
+#ifdef Q_OS_LINUX
+	// keep the kernel reading ahead of the current position by at least half a window so
+	// that reading the next chunks does not block on disk I/O
+	if( m_prefetchPos >= m_fileSize || m_prefetchPos - m_filePos >= PrefetchWindowSize / 2 )
+	{
+		return;
+	}
+
+	const auto begin = qMax( m_filePos, m_prefetchPos );
+	const auto end = qMin( m_filePos + PrefetchWindowSize, m_fileSize );
+
+	posix_fadvise( m_file.handle(), begin, end - begin, POSIX_FADV_WILLNEED );
+
+	m_prefetchPos = end;
+#endif
+}
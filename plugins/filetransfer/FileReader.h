@@ -0,0 +1,58 @@
+/*
+ * FileReader.h - declaration of FileReader class
+ *
+ * Copyright (c) 2018-2019 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <QFile>
+
+#include "ChunkReader.h"
+
+// reads a file chunk by chunk at explicit positions while letting the kernel read ahead - the
+// file is not mapped into memory as truncating it during a transfer would crash the process
+class FileReader : public ChunkReader
+{
+public:
+	explicit FileReader( const QString& fileName );
+	~FileReader() override = default;
+
+	bool open() override;
+
+	QByteArray readChunk( qint64 chunkSize ) override;
+	QByteArray readChunkAt( qint64 pos, qint64 chunkSize ) override;
+
+	qint64 size() const override;
+	bool atEnd() const override;
+	int progress() const override;
+
+private:
+	void prefetch();
+
+	static constexpr qint64 PrefetchWindowSize = 4*1024*1024;
+
+	QFile m_file;
+	qint64 m_fileSize;
+	qint64 m_filePos;
+	qint64 m_prefetchPos;
+
+};
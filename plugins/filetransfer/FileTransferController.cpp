@@ -22,9 +22,15 @@
  *
  */
 
+#include <QDateTime>
 #include <QFileInfo>
+#include <QtConcurrent>
 
-#include "FileReadThread.h"
+#include <array>
+#include <cmath>
+
+#include "ArchiveReader.h"
+#include "FileReader.h"
 #include "FileTransferController.h"
 #include "FileTransferPlugin.h"
 
@@ -37,7 +43,18 @@ FileTransferController::FileTransferController( FileTransferPlugin* plugin ) :
 	m_files(),
 	m_flags( Transfer ),
 	m_interfaces(),
-	m_fileReadThread( nullptr ),
+	m_fileReader( nullptr ),
+	m_archive( false ),
+	m_chunkHashesFuture(),
+	m_chunkHashes(),
+	m_chunkHashesCache(),
+	m_chunkCount( 0 ),
+	m_fileStarted( false ),
+	m_statusTimer(),
+	m_transferStates(),
+	m_cachedChunks(),
+	m_firstCachedChunk( 0 ),
+	m_readComplete( false ),
 	m_fileState( FileStateFinished ),
 	m_processTimer( this )
 {
@@ -49,10 +66,7 @@ FileTransferController::FileTransferController( FileTransferPlugin* plugin ) :
 
 FileTransferController::~FileTransferController()
 {
-	if( m_fileReadThread )
-	{
-		delete m_fileReadThread;
-	}
+	delete m_fileReader;
 }
 
 
@@ -100,11 +114,8 @@ void FileTransferController::stop()
 	{
 		m_processTimer.stop();
 
-		if( m_fileReadThread )
-		{
-			delete m_fileReadThread;
-			m_fileReadThread = nullptr;
-		}
+		resetTransferState();
+		closeFileReader();
 
 		m_plugin->sendCancelMessage( m_currentTransferId, m_interfaces );
 	}
@@ -135,6 +146,86 @@ bool FileTransferController::isRunning() const
 
 
 
+void FileTransferController::acknowledgeChunk( ComputerControlInterface::Pointer computerControlInterface,
+											   QUuid transferId, int chunkIndex )
+{
+	if( transferId != m_currentTransferId )
+	{
+		return;
+	}
+
+	Q_UNUSED(chunkIndex)
+
+	const auto it = m_transferStates.find( computerControlInterface.data() );
+	if( it != m_transferStates.end() )
+	{
+		++it->acknowledgedChunks;
+		it->acknowledgeTimer.restart();
+
+		// make use of new credit right away instead of waiting for next timer event
+		if( isRunning() && m_fileState == FileStateTransferring )
+		{
+			process();
+		}
+	}
+}
+
+
+
+void FileTransferController::setAvailableChunks( ComputerControlInterface::Pointer computerControlInterface,
+												 QUuid transferId, const QBitArray& availableChunks,
+												 bool compressionSupported )
+{
+	if( transferId != m_currentTransferId )
+	{
+		return;
+	}
+
+	auto& state = m_transferStates[computerControlInterface.data()];
+	state.statusReceived = true;
+	state.compressionSupported = compressionSupported;
+	state.availableChunks = availableChunks;
+
+	if( isRunning() && m_fileState == FileStateTransferring )
+	{
+		process();
+	}
+}
+
+
+
+void FileTransferController::setStatusPending( ComputerControlInterface::Pointer computerControlInterface,
+											   QUuid transferId )
+{
+	if( transferId == m_currentTransferId )
+	{
+		m_transferStates[computerControlInterface.data()].statusPending = true;
+	}
+}
+
+
+
+void FileTransferController::abortTransfer( ComputerControlInterface::Pointer computerControlInterface, QUuid transferId )
+{
+	if( transferId != m_currentTransferId || m_currentFileIndex >= m_files.count() )
+	{
+		return;
+	}
+
+	skipComputer( m_transferStates[computerControlInterface.data()] );
+
+	emit errorOccured( tr( "Computer \"%1\" could not receive file \"%2\"." ).
+					   arg( computerControlInterface->computer().name(),
+							QFileInfo( m_files[m_currentFileIndex] ).fileName() ) );
+
+	if( isRunning() && m_fileState == FileStateTransferring )
+	{
+		process();
+	}
+}
+
+
+
 void FileTransferController::process()
 {
 	switch( m_fileState )
@@ -189,23 +280,85 @@ bool FileTransferController::openFile()
 		return false;
 	}
 
-	m_fileReadThread = new FileReadThread( m_files[m_currentFileIndex], this );
+	// directories are transferred as a stream of all their entries
+	m_archive = QFileInfo( m_files[m_currentFileIndex] ).isDir();
+	if( m_archive )
+	{
+		m_fileReader = new ArchiveReader( m_files[m_currentFileIndex] );
+	}
+	else
+	{
+		m_fileReader = new FileReader( m_files[m_currentFileIndex] );
+	}
 
-	if( m_fileReadThread->start() == false )
+	if( m_fileReader->open() == false )
 	{
-		delete m_fileReadThread;
-		m_fileReadThread = nullptr;
+		delete m_fileReader;
+		m_fileReader = nullptr;
 		emit errorOccured( tr( "Could not open file \"%1\" for reading! Please check your permissions!" ).arg( m_currentFileIndex ) );
 		return false;
 	}
 
-	// start reading initial chunk in background
-	m_fileReadThread->readNextChunk( ChunkSize );
+	resetTransferState();
 
 	m_currentTransferId = QUuid::createUuid();
 
+	// hash chunks in background unless file has been hashed before
+	if( m_archive )
+	{
+		return true;
+	}
+
+	m_chunkHashes = m_chunkHashesCache.value( chunkHashesCacheKey( m_files[m_currentFileIndex] ) );
+	if( m_chunkHashes.isEmpty() )
+	{
+		const auto filePath = m_files[m_currentFileIndex];
+		m_chunkHashesFuture = QtConcurrent::run( [=]() {
+			return FileTransferPlugin::computeChunkHashes( filePath, ChunkSize );
+		} );
+	}
+
+	return true;
+}
+
+
+
+bool FileTransferController::startFile()
+{
+	if( m_archive )
+	{
+		m_chunkCount = static_cast<int>( qMax<qint64>( 1, ( m_fileReader->size() + ChunkSize - 1 ) / ChunkSize ) );
+
+		m_plugin->sendStartArchiveMessage( m_currentTransferId, QFileInfo( m_files[m_currentFileIndex] ).fileName(),
+										   m_flags.testFlag( OverwriteExistingFiles ), m_fileReader->size(),
+										   m_flags.testFlag( CompressData ), m_interfaces );
+
+		m_statusTimer.start();
+		m_fileStarted = true;
+
+		return true;
+	}
+
+	if( m_chunkHashes.isEmpty() )
+	{
+		if( m_chunkHashesFuture.isFinished() == false )
+		{
+			return false;
+		}
+
+		m_chunkHashes = m_chunkHashesFuture.result();
+		m_chunkHashesCache[chunkHashesCacheKey( m_files[m_currentFileIndex] )] = m_chunkHashes;
+	}
+
+	m_chunkCount = m_chunkHashes.size() / FileTransferPlugin::ChunkHashSize;
+
 	m_plugin->sendStartMessage( m_currentTransferId, QFileInfo( m_files[m_currentFileIndex] ).fileName(),
-								m_flags.testFlag( OverwriteExistingFiles ), m_interfaces );
+								m_flags.testFlag( OverwriteExistingFiles ),
+								QFileInfo( m_files[m_currentFileIndex] ).size(), ChunkSize, m_chunkHashes,
+								m_flags.testFlag( CompressData ), m_interfaces );
+
+	m_statusTimer.start();
+	m_fileStarted = true;
 
 	return true;
 }
@@ -214,33 +367,122 @@ bool FileTransferController::openFile()
 
 bool FileTransferController::transferFile()
 {
-	if( m_fileReadThread == nullptr )
+	if( m_fileReader == nullptr )
 	{
 		// something went wrong so finish this file
 		return true;
 	}
 
-	// wait for all clients to catch up and current data chunk to be read completely
-	if( allQueuesEmpty() == false || m_fileReadThread->isChunkReady() == false )
+	if( m_fileStarted == false && startFile() == false )
 	{
 		return false;
 	}
 
-	m_plugin->sendDataMessage( m_currentTransferId, m_fileReadThread->currentChunk(), m_interfaces );
+	auto minimumNextChunk = m_chunkCount;
+	auto allChunksAcknowledged = true;
+
+	// send as many chunks to each computer as its credit window allows
+	for( const auto& controlInterface : qAsConst(m_interfaces) )
+	{
+		if( controlInterface->state() != ComputerControlInterface::State::Connected )
+		{
+			continue;
+		}
+
+		auto& state = m_transferStates[controlInterface.data()];
 
-	m_fileReadThread->readNextChunk( ChunkSize );
+		// computers announcing a status report may need to hash large existing files before sending it
+		if( state.statusReceived == false && state.statusPending && m_statusTimer.hasExpired( pendingStatusTimeout() ) )
+		{
+			skipComputer( state );
+			state.statusPending = false;
+
+			emit errorOccured( tr( "Computer \"%1\" did not respond to the transfer of file \"%2\" in time." ).
+							   arg( controlInterface->computer().name(),
+									QFileInfo( m_files[m_currentFileIndex] ).fileName() ) );
+		}
+
+		const auto statusTimedOut = state.statusPending == false && m_statusTimer.elapsed() >= StatusReplyTimeout;
+
+		// computers not confirming the start of an archive transfer can't unpack it
+		if( m_archive && state.statusReceived == false && statusTimedOut )
+		{
+			state.nextChunk = m_chunkCount;
+		}
+
+		// wait for computer to report chunks it already has unless it does not support resuming
+		if( state.statusReceived || statusTimedOut )
+		{
+			while( state.nextChunk < m_chunkCount )
+			{
+				if( state.nextChunk < state.availableChunks.size() &&
+					state.availableChunks.testBit( state.nextChunk ) )
+				{
+					++state.nextChunk;
+					continue;
+				}
+
+				if( canSendChunk( controlInterface, state ) == false )
+				{
+					break;
+				}
+
+				const auto chunk = cachedChunk( state.nextChunk );
+				if( chunk )
+				{
+					sendChunk( controlInterface, state, *chunk );
+				}
+				else
+				{
+					// computer lags behind the others by more than the cache size so re-read chunk
+					// instead of stalling all other computers
+					CachedChunk rereadChunk;
+					rereadChunk.data = m_fileReader->readChunkAt( qint64( state.nextChunk ) * ChunkSize, ChunkSize );
+					sendChunk( controlInterface, state, rereadChunk );
+				}
+			}
+		}
+
+		// computers acknowledging chunks only do so once written to disk so wait for all of them
+		// before finishing the file as otherwise write errors could not be reported anymore
+		if( ( state.statusReceived || state.acknowledgedChunks > 0 ) && state.acknowledgedChunks < state.sentChunks )
+		{
+			// do not wait forever for computers which stopped acknowledging (e.g. crashed or restarted worker)
+			if( state.acknowledgeTimer.hasExpired( AcknowledgeTimeout ) )
+			{
+				skipComputer( state );
+
+				emit errorOccured( tr( "Computer \"%1\" did not confirm receiving file \"%2\" in time." ).
+								   arg( controlInterface->computer().name(),
+										QFileInfo( m_files[m_currentFileIndex] ).fileName() ) );
+			}
+			else
+			{
+				allChunksAcknowledged = false;
+			}
+		}
 
-	return m_fileReadThread->atEnd();
+		minimumNextChunk = qMin( minimumNextChunk, state.nextChunk );
+	}
+
+	// drop chunks which have been sent to or are available on all computers
+	while( m_cachedChunks.isEmpty() == false && m_firstCachedChunk < minimumNextChunk )
+	{
+		m_cachedChunks.removeFirst();
+		++m_firstCachedChunk;
+	}
+
+	return minimumNextChunk >= m_chunkCount && allChunksAcknowledged;
 }
 
 
 
 void FileTransferController::finishFile()
 {
-	if( m_fileReadThread )
+	if( m_fileReader )
 	{
-		delete m_fileReadThread;
-		m_fileReadThread = nullptr;
+		resetTransferState();
+		closeFileReader();
 
 		m_plugin->sendFinishMessage( m_currentTransferId, QFileInfo( m_files[m_currentFileIndex] ).fileName(),
 									 m_flags.testFlag( OpenFilesInApplication ), m_interfaces );
@@ -251,30 +493,202 @@ void FileTransferController::finishFile()
 
 
 
-void FileTransferController::updateProgress()
+/*!
+ * \brief Returns the given chunk from the cache which is filled with chunks read sequentially
+ * \return nullptr if the chunk has been dropped from the cache already
+ *
+ * The cache follows the fastest computer, i.e. old chunks are dropped once the cache is full
+ * so computers lagging behind do not limit the speed of all other computers.
+ */
+FileTransferController::CachedChunk* FileTransferController::cachedChunk( int index )
 {
-	if( m_files.isEmpty() == false && m_fileReadThread )
+	if( index < m_firstCachedChunk )
 	{
-		emit progressChanged( m_currentFileIndex * 100 / m_files.count() +
-							  m_fileReadThread->progress() / m_files.count() );
+		return nullptr;
 	}
-	else if( m_files.count() > 0 && m_currentFileIndex >= m_files.count() )
+
+	while( index >= m_firstCachedChunk + m_cachedChunks.count() && m_readComplete == false )
 	{
-		emit progressChanged( 100 );
+		if( m_cachedChunks.count() >= MaxCachedChunks )
+		{
+			m_cachedChunks.removeFirst();
+			++m_firstCachedChunk;
+		}
+
+		CachedChunk chunk;
+		chunk.data = m_fileReader->readChunk( ChunkSize );
+		m_cachedChunks.append( chunk );
+
+		m_readComplete = m_fileReader->atEnd();
 	}
+
+	if( index < m_firstCachedChunk || index >= m_firstCachedChunk + m_cachedChunks.count() )
+	{
+		return nullptr;
+	}
+
+	return &m_cachedChunks[index - m_firstCachedChunk];
 }
 
 
 
-bool FileTransferController::allQueuesEmpty()
+void FileTransferController::sendChunk( const ComputerControlInterface::Pointer& controlInterface,
+										TransferState& state, CachedChunk& chunk )
 {
-	for( const auto& controlInterface : qAsConst(m_interfaces) )
+	if( state.compressionSupported && compressedChunk( chunk ).isEmpty() == false )
+	{
+		m_plugin->sendDataMessage( m_currentTransferId, state.nextChunk, chunk.compressedData, true,
+								   { controlInterface } );
+	}
+	else
+	{
+		m_plugin->sendDataMessage( m_currentTransferId, state.nextChunk, chunk.data, false,
+								   { controlInterface } );
+	}
+
+	// measure time without progress starting from the first unacknowledged chunk
+	if( state.sentChunks <= state.acknowledgedChunks )
+	{
+		state.acknowledgeTimer.restart();
+	}
+
+	++state.nextChunk;
+	++state.sentChunks;
+}
+
+
+
+/*!
+ * \brief Stops sending chunks to a computer and waiting for acknowledgements of chunks sent so far
+ */
+void FileTransferController::skipComputer( TransferState& state )
+{
+	state.nextChunk = m_chunkCount;
+	state.sentChunks = state.acknowledgedChunks;
+}
+
+
+
+qint64 FileTransferController::pendingStatusTimeout() const
+{
+	return AcknowledgeTimeout + m_fileReader->size() * 1000 / MinimumHashingRate;
+}
+
+
+
+const QByteArray& FileTransferController::compressedChunk( CachedChunk& chunk )
+{
+	// compress each chunk at most once regardless of the number of computers
+	if( chunk.compressionProbed == false )
 	{
-		if( controlInterface->isMessageQueueEmpty() == false )
+		chunk.compressionProbed = true;
+
+		if( isCompressible( chunk.data ) )
 		{
-			return false;
+			const auto compressedData = qCompress( chunk.data, CompressionLevel );
+
+			// only use compressed data if it actually saves bandwidth
+			if( compressedData.size() < chunk.data.size() * 9 / 10 )
+			{
+				chunk.compressedData = compressedData;
+			}
 		}
 	}
 
-	return true;
+	return chunk.compressedData;
 }
+
+
+
+bool FileTransferController::isCompressible( const QByteArray& data )
+{
+	if( data.size() < EntropyProbeSize )
+	{
+		return data.isEmpty() == false;
+	}
+
+	// estimate entropy from evenly distributed samples in order to skip already compressed data
+	const auto step = data.size() / EntropyProbeSize;
+
+	std::array<int, 256> histogram{};
+	for( int i = 0; i < EntropyProbeSize; ++i )
+	{
+		++histogram[static_cast<uchar>( data[i * step] )];
+	}
+
+	double entropy = 0;
+	for( const auto count : histogram )
+	{
+		if( count > 0 )
+		{
+			const auto probability = static_cast<double>( count ) / EntropyProbeSize;
+			entropy -= probability * std::log2( probability );
+		}
+	}
+
+	return entropy < MaximumCompressibleEntropy;
+}
+
+
+
+bool FileTransferController::canSendChunk( const ComputerControlInterface::Pointer& controlInterface,
+										   const TransferState& state )
+{
+	// computers not acknowledging chunks (yet) are paced by their message queue
+	if( state.acknowledgedChunks <= 0 )
+	{
+		return controlInterface->isMessageQueueEmpty();
+	}
+
+	return state.sentChunks - state.acknowledgedChunks < WindowSize;
+}
+
+
+
+QString FileTransferController::chunkHashesCacheKey( const QString& fileName )
+{
+	const QFileInfo fileInfo( fileName );
+
+	return QStringLiteral("%1:%2:%3").arg( fileInfo.absoluteFilePath() ).
+			arg( fileInfo.size() ).arg( fileInfo.lastModified().toMSecsSinceEpoch() );
+}
+
+
+
+void FileTransferController::resetTransferState()
+{
+	m_transferStates.clear();
+	m_cachedChunks.clear();
+	m_firstCachedChunk = 0;
+	m_readComplete = false;
+	m_chunkHashesFuture = {};
+	m_chunkHashes.clear();
+	m_chunkCount = 0;
+	m_fileStarted = false;
+}
+
+
+
+void FileTransferController::closeFileReader()
+{
+	// chunks own their data so queued messages do not depend on the reader
+	delete m_fileReader;
+	m_fileReader = nullptr;
+}
+
+
+
+void FileTransferController::updateProgress()
+{
+	if( m_files.isEmpty() == false && m_fileReader )
+	{
+		emit progressChanged( m_currentFileIndex * 100 / m_files.count() +
+							  m_fileReader->progress() / m_files.count() );
+	}
+	else if( m_files.count() > 0 && m_currentFileIndex >= m_files.count() )
+	{
+		emit progressChanged( 100 );
+	}
+}
+
+
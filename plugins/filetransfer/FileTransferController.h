@@ -24,11 +24,14 @@
 
 #pragma once
 
+#include <QBitArray>
+#include <QElapsedTimer>
+#include <QFuture>
 #include <QTimer>
 
 #include "ComputerControlInterface.h"
 
-class FileReadThread;
+class ChunkReader;
 class FileTransferPlugin;
 
 class FileTransferController : public QObject
@@ -40,6 +43,7 @@ public:
 		OpenFilesInApplication = 0x01,
 		OpenTransferFolder = 0x02,
 		OverwriteExistingFiles = 0x04,
+		CompressData = 0x08,
 	};
 	Q_DECLARE_FLAGS(Flags, Flag)
 	Q_FLAG(Flags)
@@ -60,6 +64,13 @@ public:
 
 	bool isRunning() const;
 
+	void acknowledgeChunk( ComputerControlInterface::Pointer computerControlInterface,
+						   QUuid transferId, int chunkIndex );
+	void setAvailableChunks( ComputerControlInterface::Pointer computerControlInterface,
+							 QUuid transferId, const QBitArray& availableChunks, bool compressionSupported );
+	void setStatusPending( ComputerControlInterface::Pointer computerControlInterface, QUuid transferId );
+	void abortTransfer( ComputerControlInterface::Pointer computerControlInterface, QUuid transferId );
+
 signals:
 	void errorOccured( const QString& message );
 	void filesChanged();
@@ -74,18 +85,55 @@ private:
 		FileStateFinished
 	};
 
+	struct TransferState
+	{
+		int nextChunk{0};
+		int sentChunks{0};
+		int acknowledgedChunks{0};
+		bool statusReceived{false};
+		bool statusPending{false};
+		bool compressionSupported{false};
+		QBitArray availableChunks;
+		QElapsedTimer acknowledgeTimer;
+	};
+
+	struct CachedChunk
+	{
+		QByteArray data;
+		QByteArray compressedData;
+		bool compressionProbed{false};
+	};
+
 	void process();
 
 	bool openFile();
+	bool startFile();
 	bool transferFile();
 	void finishFile();
 
-	void updateProgress();
+	CachedChunk* cachedChunk( int index );
+	const QByteArray& compressedChunk( CachedChunk& chunk );
+	void sendChunk( const ComputerControlInterface::Pointer& controlInterface, TransferState& state, CachedChunk& chunk );
+	void skipComputer( TransferState& state );
+	qint64 pendingStatusTimeout() const;
+	static bool isCompressible( const QByteArray& data );
+	bool canSendChunk( const ComputerControlInterface::Pointer& controlInterface, const TransferState& state );
+	static QString chunkHashesCacheKey( const QString& fileName );
+	void resetTransferState();
+	void closeFileReader();
 
-	bool allQueuesEmpty();
+	void updateProgress();
 
 	static constexpr int ProcessInterval = 25;
 	static constexpr int ChunkSize = 256*1024;
+	static constexpr int WindowSize = 8;
+	static constexpr int MaxCachedChunks = 64;
+	static constexpr int StatusReplyTimeout = 3000;
+	static constexpr int AcknowledgeTimeout = 30000;
+	static constexpr int MinimumHashingRate = 10*1024*1024;
+	static constexpr int CompressionLevel = 1;
+	static constexpr int EntropyProbeSize = 4096;
+	static constexpr double MaximumCompressibleEntropy = 7.5;
 
 	FileTransferPlugin* m_plugin;
 
@@ -95,7 +143,20 @@ private:
 	Flags m_flags;
 	ComputerControlInterfaceList m_interfaces;
 
-	FileReadThread* m_fileReadThread;
+	ChunkReader* m_fileReader;
+	bool m_archive;
+
+	QFuture<QByteArray> m_chunkHashesFuture;
+	QByteArray m_chunkHashes;
+	QHash<QString, QByteArray> m_chunkHashesCache;
+	int m_chunkCount;
+	bool m_fileStarted;
+	QElapsedTimer m_statusTimer;
+
+	QHash<ComputerControlInterface *, TransferState> m_transferStates;
+	QList<CachedChunk> m_cachedChunks;
+	int m_firstCachedChunk;
+	bool m_readComplete;
 
 	FileState m_fileState;
 
@@ -22,6 +22,7 @@
  *
  */
 
+#include <QFileDialog>
 #include <QPushButton>
 
 #include "FileTransferController.h"
@@ -34,11 +35,15 @@ FileTransferDialog::FileTransferDialog( FileTransferController* controller, QWid
 	QDialog( parent ),
 	ui( new Ui::FileTransferDialog ),
 	m_controller( controller ),
-	m_listModel( new FileTransferListModel( m_controller, this ) )
+	m_listModel( new FileTransferListModel( m_controller, this ) ),
+	m_addDirectoryButton( nullptr )
 {
 	ui->setupUi( this );
 	ui->buttonBox->button( QDialogButtonBox::Ok )->setText( tr( "Start" ) );
 
+	m_addDirectoryButton = ui->buttonBox->addButton( tr( "Add directory" ), QDialogButtonBox::ActionRole );
+	connect( m_addDirectoryButton, &QPushButton::clicked, this, &FileTransferDialog::addDirectory );
+
 	ui->fileListView->setModel( m_listModel );
 
 	connect( m_controller, &FileTransferController::progressChanged,
@@ -63,6 +68,7 @@ void FileTransferDialog::accept()
 {
 	ui->optionsGroupBox->setDisabled( true );
 	ui->buttonBox->setStandardButtons( QDialogButtonBox::Cancel );
+	m_addDirectoryButton->hide();
 
 	FileTransferController::Flags flags( FileTransferController::Transfer );
 
@@ -81,6 +87,11 @@ void FileTransferDialog::accept()
 		flags |= FileTransferController::OverwriteExistingFiles;
 	}
 
+	if( ui->compressData->isChecked() )
+	{
+		flags |= FileTransferController::CompressData;
+	}
+
 	m_controller->setFlags( flags );
 	m_controller->start();
 }
@@ -108,6 +119,18 @@ void FileTransferDialog::finish()
 
 
 
+void FileTransferDialog::addDirectory()
+{
+	const auto directory = QFileDialog::getExistingDirectory( this, tr( "Select a directory to transfer" ) );
+
+	if( directory.isEmpty() == false )
+	{
+		m_controller->setFiles( m_controller->files() + QStringList( directory ) );
+	}
+}
+
+
+
 void FileTransferDialog::updateProgress( int progress )
 {
 	ui->progressBar->setValue( progress );
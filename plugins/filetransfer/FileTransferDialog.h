@@ -26,6 +26,8 @@
 
 namespace Ui { class FileTransferDialog; }
 
+class QPushButton;
+
 class FileTransferController;
 class FileTransferListModel;
 
@@ -41,11 +43,14 @@ private:
 	void reject() override;
 	void finish();
 
+	void addDirectory();
+
 	void updateProgress( int progress );
 
 	Ui::FileTransferDialog* ui;
 
 	FileTransferController* m_controller;
 	FileTransferListModel* m_listModel;
+	QPushButton* m_addDirectoryButton;
 
 } ;
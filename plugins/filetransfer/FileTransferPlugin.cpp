@@ -25,14 +25,18 @@
 #include <QDesktopServices>
 #include <QFileDialog>
 #include <QFileInfo>
+#include <QFutureWatcher>
 #include <QMessageBox>
 #include <QQuickWindow>
+#include <QtConcurrent>
 
+#include "ArchiveWriter.h"
 #include "BuiltinFeatures.h"
 #include "FileTransferController.h"
 #include "FileTransferDialog.h"
 #include "FileTransferPlugin.h"
 #include "FileTransferUserConfiguration.h"
+#include "FileWriter.h"
 #include "FeatureWorkerManager.h"
 #include "QmlCore.h"
 #include "SystemTrayIcon.h"
@@ -52,8 +56,15 @@ FileTransferPlugin::FileTransferPlugin( QObject* parent ) :
 						   QStringLiteral(":/filetransfer/applications-office.png") ),
 	m_features( { m_fileTransferFeature } ),
 	m_fileTransferController( nullptr ),
-	m_currentFile(),
-	m_currentTransferId()
+	m_partialFiles(),
+	m_currentFileName(),
+	m_overwriteCurrentFile( false ),
+	m_currentFileWriter( nullptr ),
+	m_currentTransferId(),
+	m_currentFileSize( -1 ),
+	m_currentChunkSize( 0 ),
+	m_currentArchive( nullptr ),
+	m_currentCompression( NoCompression )
 {
 }
 
@@ -62,6 +73,14 @@ FileTransferPlugin::FileTransferPlugin( QObject* parent ) :
 FileTransferPlugin::~FileTransferPlugin()
 {
 	delete m_fileTransferController;
+	delete m_currentArchive;
+	delete m_currentFileWriter;
+
+	// partial files which have not been resumed are of no use anymore
+	for( const auto& partialFile : qAsConst( m_partialFiles ) )
+	{
+		QFile::remove( partialFile );
+	}
 }
 
 
@@ -132,8 +151,49 @@ bool FileTransferPlugin::handleFeatureMessage( VeyonMasterInterface& master, con
 											   ComputerControlInterface::Pointer computerControlInterface )
 {
 	Q_UNUSED(master)
-	Q_UNUSED(message)
-	Q_UNUSED(computerControlInterface)
+
+	if( m_fileTransferFeature.uid() == message.featureUid() &&
+		message.command() == FileTransferAcknowledgeCommand )
+	{
+		if( m_fileTransferController )
+		{
+			m_fileTransferController->acknowledgeChunk( computerControlInterface,
+														message.argument( TransferId ).toUuid(),
+														message.argument( ChunkIndex ).toInt() );
+		}
+
+		return true;
+	}
+
+	if( m_fileTransferFeature.uid() == message.featureUid() &&
+		message.command() == FileTransferStatusCommand )
+	{
+		if( m_fileTransferController && message.argument( StatusPending ).toBool() )
+		{
+			m_fileTransferController->setStatusPending( computerControlInterface,
+														message.argument( TransferId ).toUuid() );
+		}
+		else if( m_fileTransferController )
+		{
+			m_fileTransferController->setAvailableChunks( computerControlInterface,
+														  message.argument( TransferId ).toUuid(),
+														  message.argument( AvailableChunks ).toBitArray(),
+														  message.argument( Compression ).toInt() == ZlibCompression );
+		}
+
+		return true;
+	}
+
+	if( m_fileTransferFeature.uid() == message.featureUid() &&
+		message.command() == FileTransferErrorCommand )
+	{
+		if( m_fileTransferController )
+		{
+			m_fileTransferController->abortTransfer( computerControlInterface, message.argument( TransferId ).toUuid() );
+		}
+
+		return true;
+	}
 
 	return false;
 }
@@ -144,16 +204,57 @@ bool FileTransferPlugin::handleFeatureMessage( VeyonServerInterface& server,
 											   const MessageContext& messageContext,
 											   const FeatureMessage& message )
 {
-	Q_UNUSED(messageContext)
-
 	if( m_fileTransferFeature.uid() == message.featureUid() )
 	{
+		const auto transferId = message.argument( TransferId ).toUuid();
+
+		if( message.command() == FileTransferAcknowledgeCommand ||
+			message.command() == FileTransferStatusCommand ||
+			message.command() == FileTransferErrorCommand )
+		{
+			// relay acknowledgement/status/errors from worker to the master which initiated the transfer
+			const auto replyDevice = m_transferReplyDevices.value( transferId );
+			if( replyDevice )
+			{
+				server.sendFeatureMessageReply( MessageContext( replyDevice ), message );
+			}
+
+			// failed transfers must not be reported as received when finished by the master
+			if( message.command() == FileTransferErrorCommand )
+			{
+				m_transferReplyDevices.remove( transferId );
+			}
+
+			return true;
+		}
+
+		auto transferFailed = false;
+
+		switch( message.command() )
+		{
+		case FileTransferStartCommand:
+			addTransferReplyDevice( transferId, messageContext.ioDevice() );
+			// let the master know right away that the status is going to be reported as starting the
+			// worker and hashing existing data may take longer than the master waits for older workers
+			server.sendFeatureMessageReply( messageContext,
+											FeatureMessage( m_fileTransferFeature.uid(), FileTransferStatusCommand ).
+											addArgument( TransferId, transferId ).
+											addArgument( StatusPending, true ) );
+			break;
+		case FileTransferCancelCommand:
+		case FileTransferFinishCommand:
+			transferFailed = m_transferReplyDevices.remove( transferId ) == 0;
+			break;
+		default:
+			break;
+		}
+
 		if( server.featureWorkerManager().isWorkerRunning( m_fileTransferFeature ) == false )
 		{
 			server.featureWorkerManager().startWorker( m_fileTransferFeature, FeatureWorkerManager::UnmanagedSessionProcess );
 		}
 
-		if( message.command() == FileTransferFinishCommand )
+		if( message.command() == FileTransferFinishCommand && transferFailed == false )
 		{
 			VeyonCore::builtinFeatures().systemTrayIcon().showMessage( m_fileTransferFeature.displayName(),
 																	   tr( "Received file \"%1\"." ).
@@ -174,51 +275,68 @@ bool FileTransferPlugin::handleFeatureMessage( VeyonServerInterface& server,
 
 bool FileTransferPlugin::handleFeatureMessage( VeyonWorkerInterface& worker, const FeatureMessage& message )
 {
-	Q_UNUSED(worker)
-
 	if( m_fileTransferFeature.uid() == message.featureUid() )
 	{
 		switch( message.command() )
 		{
 		case FileTransferStartCommand:
-			m_currentFile.close();
-			// TODO: make path configurable
-			m_currentFile.setFileName( QDir::homePath() + QDir::separator() + message.argument( Filename ).toString() );
-			if( m_currentFile.exists() && message.argument( OverwriteExistingFile ).toBool() == false )
-			{
-				QMessageBox::critical( nullptr, m_fileTransferFeature.displayName(),
-									   tr( "Could not receive file \"%1\" as it already exists." ).
-									   arg( m_currentFile.fileName() ) );
-				return true;
-			}
-
-			if( m_currentFile.open( QFile::WriteOnly | QFile::Truncate ) )
+			if( message.argument( Archive ).toBool() )
 			{
-				m_currentTransferId = message.argument( TransferId ).toUuid();
+				startReceivingArchive( worker, message );
 			}
 			else
 			{
-				QMessageBox::critical( nullptr, m_fileTransferFeature.displayName(),
-									   tr( "Could not receive file \"%1\" as it could not be opened for writing!" ).
-									   arg( m_currentFile.fileName() ) );
+				startReceivingFile( worker, message );
 			}
 			return true;
 
 		case FileTransferContinueCommand:
-			if( message.argument( TransferId ).toUuid() == m_currentTransferId )
+		{
+			QByteArray data;
+			if( message.argument( TransferId ).toUuid() == m_currentTransferId &&
+				( m_currentArchive || m_currentFileWriter ) &&
+				dataChunk( message, data ) == false )
+			{
+				failTransfer( worker, tr( "Could not receive file \"%1\" as the received data is corrupt." ).
+										arg( m_currentArchive ? m_currentArchive->directory() : m_currentFileName ) );
+			}
+			else if( message.argument( TransferId ).toUuid() == m_currentTransferId && m_currentArchive )
 			{
-				m_currentFile.write( message.argument( DataChunk ).toByteArray() );
+				// do not acknowledge chunks of failed transfers
+				if( receiveArchiveData( worker, data ) && message.argument( ChunkIndex ).isValid() )
+				{
+					worker.sendFeatureMessageReply( FeatureMessage( m_fileTransferFeature.uid(), FileTransferAcknowledgeCommand ).
+													addArgument( TransferId, message.argument( TransferId ) ).
+													addArgument( ChunkIndex, message.argument( ChunkIndex ) ) );
+				}
+			}
+			else if( message.argument( TransferId ).toUuid() == m_currentTransferId && m_currentFileWriter )
+			{
+				// resumable transfers write chunks at their respective position
+				const auto chunkIndex = message.argument( ChunkIndex );
+				m_currentFileWriter->write( m_currentFileSize >= 0 ? chunkIndex.toLongLong() * m_currentChunkSize : -1,
+											data, chunkIndex.isValid() ? chunkIndex.toInt() : -1 );
 			}
 			else
 			{
 				vWarning() << "received chunk for unknown transfer ID";
 			}
 			return true;
+		}
 
 		case FileTransferCancelCommand:
-			if( message.argument( TransferId ).toUuid() == m_currentTransferId )
+			if( message.argument( TransferId ).toUuid() == m_currentTransferId && m_currentArchive )
+			{
+				m_currentArchive->abort();
+				delete m_currentArchive;
+				m_currentArchive = nullptr;
+				m_currentTransferId = QUuid();
+			}
+			else if( message.argument( TransferId ).toUuid() == m_currentTransferId )
 			{
-				m_currentFile.remove();
+				// keep partially received file of resumable transfers so they can be resumed later on
+				closeFileWriter( m_currentFileSize < 0 );
+				m_currentTransferId = QUuid();
 			}
 			else
 			{
@@ -227,12 +345,12 @@ bool FileTransferPlugin::handleFeatureMessage( VeyonWorkerInterface& worker, con
 			return true;
 
 		case FileTransferFinishCommand:
-			m_currentFile.close();
-			if( message.argument( OpenFileInApplication ).toBool() )
+			if( m_currentArchive )
 			{
-				QDesktopServices::openUrl( QUrl::fromLocalFile( m_currentFile.fileName() ) );
+				finishReceivingArchive( message.argument( OpenFileInApplication ).toBool() );
+				return true;
 			}
-			m_currentFile.setFileName( {} );
+			finishFileWriter( message.argument( OpenFileInApplication ).toBool() );
 			return true;
 
 		case OpenTransferFolder:
@@ -250,23 +368,47 @@ bool FileTransferPlugin::handleFeatureMessage( VeyonWorkerInterface& worker, con
 
 
 void FileTransferPlugin::sendStartMessage( QUuid transferId, const QString& fileName,
-										   bool overwriteExistingFile, const ComputerControlInterfaceList& interfaces )
+										   bool overwriteExistingFile, qint64 fileSize, int chunkSize,
+										   const QByteArray& chunkHashes, bool compressData,
+										   const ComputerControlInterfaceList& interfaces )
 {
 	sendFeatureMessage( FeatureMessage( m_fileTransferFeature.uid(), FileTransferStartCommand ).
 						addArgument( TransferId, transferId ).
 						addArgument( Filename, fileName ).
-						addArgument( OverwriteExistingFile, overwriteExistingFile ),
+						addArgument( OverwriteExistingFile, overwriteExistingFile ).
+						addArgument( FileSize, fileSize ).
+						addArgument( ChunkSize, chunkSize ).
+						addArgument( ChunkHashes, chunkHashes ).
+						addArgument( Compression, compressData ? ZlibCompression : NoCompression ),
+						interfaces );
+}
+
+
+
+void FileTransferPlugin::sendStartArchiveMessage( QUuid transferId, const QString& directoryName,
+												  bool overwriteExistingFiles, qint64 archiveSize,
+												  bool compressData, const ComputerControlInterfaceList& interfaces )
+{
+	sendFeatureMessage( FeatureMessage( m_fileTransferFeature.uid(), FileTransferStartCommand ).
+						addArgument( TransferId, transferId ).
+						addArgument( Filename, directoryName ).
+						addArgument( OverwriteExistingFile, overwriteExistingFiles ).
+						addArgument( FileSize, archiveSize ).
+						addArgument( Archive, true ).
+						addArgument( Compression, compressData ? ZlibCompression : NoCompression ),
 						interfaces );
 }
 
 
 
-void FileTransferPlugin::sendDataMessage( QUuid transferId, const QByteArray& data,
+void FileTransferPlugin::sendDataMessage( QUuid transferId, int chunkIndex, const QByteArray& data, bool compressed,
 										  const ComputerControlInterfaceList& interfaces )
 {
 	sendFeatureMessage( FeatureMessage( m_fileTransferFeature.uid(), FileTransferContinueCommand ).
 						addArgument( TransferId, transferId ).
-						addArgument( DataChunk, data ),
+						addArgument( ChunkIndex, chunkIndex ).
+						addArgument( DataChunk, data ).
+						addArgument( Compressed, compressed ),
 						interfaces );
 }
 
@@ -299,6 +441,420 @@ void FileTransferPlugin::sendOpenTransferFolderMessage( const ComputerControlInt
 
 
 
+QByteArray FileTransferPlugin::computeChunkHashes( const QString& fileName, qint64 chunkSize, qint64 maximumSize )
+{
+	QFile file( fileName );
+	if( chunkSize <= 0 || file.open( QFile::ReadOnly ) == false )
+	{
+		return {};
+	}
+
+	auto remainingSize = maximumSize >= 0 ? qMin( maximumSize, file.size() ) : file.size();
+
+	QByteArray chunkHashes;
+	chunkHashes.reserve( static_cast<int>( ( remainingSize / chunkSize + 1 ) * ChunkHashSize ) );
+
+	do
+	{
+		const auto chunk = file.read( qMin( chunkSize, remainingSize ) );
+		chunkHashes.append( QCryptographicHash::hash( chunk, ChunkHashAlgorithm ) );
+		remainingSize -= chunk.size();
+
+		if( chunk.isEmpty() )
+		{
+			break;
+		}
+	}
+	while( remainingSize > 0 );
+
+	return chunkHashes;
+}
+
+
+
+void FileTransferPlugin::startReceivingFile( VeyonWorkerInterface& worker, const FeatureMessage& message )
+{
+	if( m_currentArchive )
+	{
+		m_currentArchive->abort();
+		delete m_currentArchive;
+		m_currentArchive = nullptr;
+	}
+
+	closeFileWriter( false );
+	m_currentTransferId = QUuid();
+	m_currentFileSize = -1;
+	m_currentCompression = NoCompression;
+
+	// TODO: make path configurable
+	m_currentFileName = QDir::homePath() + QDir::separator() + message.argument( Filename ).toString();
+
+	const auto overwriteExistingFile = message.argument( OverwriteExistingFile ).toBool();
+	const auto chunkHashes = message.argument( ChunkHashes ).toByteArray();
+
+	m_overwriteCurrentFile = overwriteExistingFile;
+
+	if( chunkHashes.isEmpty() )
+	{
+		// non-resumable transfer initiated by older master
+		m_currentTransferId = message.argument( TransferId ).toUuid();
+
+		if( QFileInfo::exists( m_currentFileName ) && overwriteExistingFile == false )
+		{
+			failTransfer( worker, tr( "Could not receive file \"%1\" as it already exists." ).
+									arg( m_currentFileName ) );
+			return;
+		}
+
+		openFileWriter( worker, QFile::WriteOnly | QFile::Truncate );
+		return;
+	}
+
+	m_currentTransferId = message.argument( TransferId ).toUuid();
+	m_currentFileSize = message.argument( FileSize ).toLongLong();
+	m_currentCompression = message.argument( Compression ).toInt() == ZlibCompression ? ZlibCompression : NoCompression;
+	m_currentChunkSize = message.argument( ChunkSize ).toLongLong();
+
+	// an existing file must not be touched unless it turns out to be identical or has been
+	// left behind by an interrupted transfer which can be resumed now
+	if( QFileInfo::exists( m_currentFileName ) == false || overwriteExistingFile ||
+		m_partialFiles.remove( m_currentFileName ) )
+	{
+		if( openFileWriter( worker, QFile::ReadWrite, m_currentFileSize ) == false )
+		{
+			return;
+		}
+	}
+
+	checkAvailableChunks( worker, chunkHashes );
+}
+
+
+
+void FileTransferPlugin::checkAvailableChunks( VeyonWorkerInterface& worker, const QByteArray& chunkHashes )
+{
+	const auto transferId = m_currentTransferId;
+	const auto fileName = m_currentFileName;
+	const auto fileSize = m_currentFileSize;
+	const auto chunkSize = m_currentChunkSize;
+	const auto compression = m_currentCompression;
+
+	// hash existing data in background in order to not block the user session
+	auto watcher = new QFutureWatcher<QByteArray>( this );
+	connect( watcher, &QFutureWatcher<QByteArray>::finished, this,
+			 [=, &worker]() {
+		watcher->deleteLater();
+
+		if( transferId != m_currentTransferId )
+		{
+			return;
+		}
+
+		const auto existingChunkHashes = watcher->result();
+		const auto chunkCount = chunkHashes.size() / ChunkHashSize;
+
+		QBitArray availableChunks( chunkCount );
+		for( int i = 0; i < chunkCount && ( i + 1 ) * ChunkHashSize <= existingChunkHashes.size(); ++i )
+		{
+			availableChunks.setBit( i, existingChunkHashes.mid( i * ChunkHashSize, ChunkHashSize ) ==
+										chunkHashes.mid( i * ChunkHashSize, ChunkHashSize ) );
+		}
+
+		const auto identical = availableChunks.count( true ) == chunkCount &&
+							   QFileInfo( fileName ).size() == fileSize;
+
+		if( m_currentFileWriter == nullptr && identical == false )
+		{
+			failTransfer( worker, tr( "Could not receive file \"%1\" as it already exists." ).arg( fileName ) );
+			return;
+		}
+
+		worker.sendFeatureMessageReply( FeatureMessage( m_fileTransferFeature.uid(), FileTransferStatusCommand ).
+										addArgument( TransferId, transferId ).
+										addArgument( AvailableChunks, availableChunks ).
+										addArgument( Compression, compression ) );
+	} );
+
+	watcher->setFuture( QtConcurrent::run( [=]() {
+		return QFileInfo::exists( fileName ) ? computeChunkHashes( fileName, chunkSize, fileSize ) : QByteArray();
+	} ) );
+}
+
+
+
+bool FileTransferPlugin::openFileWriter( VeyonWorkerInterface& worker, QIODevice::OpenMode openMode,
+										 qint64 preallocateSize )
+{
+	m_currentFileWriter = new FileWriter( m_currentFileName, this );
+
+	// grant credit for the next chunk to the sender once the chunk has been written to disk
+	const auto transferId = m_currentTransferId;
+	connect( m_currentFileWriter, &FileWriter::chunkWritten, this, [=, &worker]( int chunkIndex ) {
+		worker.sendFeatureMessageReply( FeatureMessage( m_fileTransferFeature.uid(), FileTransferAcknowledgeCommand ).
+										addArgument( TransferId, transferId ).
+										addArgument( ChunkIndex, chunkIndex ) );
+	} );
+
+	const auto fileWriter = m_currentFileWriter;
+	connect( m_currentFileWriter, &FileWriter::writingFailed, this, [=, &worker]() {
+		if( fileWriter == m_currentFileWriter && transferId == m_currentTransferId )
+		{
+			failTransfer( worker, tr( "Could not receive file \"%1\" as it could not be written completely!" ).
+									arg( fileWriter->fileName() ) );
+		}
+	} );
+
+	if( m_currentFileWriter->open( openMode, preallocateSize ) == false )
+	{
+		delete m_currentFileWriter;
+		m_currentFileWriter = nullptr;
+
+		failTransfer( worker, tr( "Could not receive file \"%1\" as it could not be opened for writing!" ).
+								arg( m_currentFileName ) );
+		return false;
+	}
+
+	return true;
+}
+
+
+
+void FileTransferPlugin::closeFileWriter( bool removeFile )
+{
+	if( m_currentFileWriter )
+	{
+		// remember partial files we created so a later transfer of the same file may resume it
+		if( removeFile == false && m_currentFileSize >= 0 && m_overwriteCurrentFile == false )
+		{
+			m_partialFiles.insert( m_currentFileName );
+		}
+
+		m_currentFileWriter->cancel( removeFile );
+		delete m_currentFileWriter;
+		m_currentFileWriter = nullptr;
+	}
+}
+
+
+
+void FileTransferPlugin::finishFileWriter( bool openFileInApplication )
+{
+	const auto fileName = m_currentFileName;
+
+	m_currentFileName.clear();
+	m_currentTransferId = QUuid();
+
+	if( m_currentFileWriter == nullptr )
+	{
+		// file already existed with identical contents
+		if( openFileInApplication && fileName.isEmpty() == false )
+		{
+			QDesktopServices::openUrl( QUrl::fromLocalFile( fileName ) );
+		}
+		return;
+	}
+
+	// let pending chunks be written and flushed to disk in background
+	auto fileWriter = m_currentFileWriter;
+	m_currentFileWriter = nullptr;
+
+	connect( fileWriter, &FileWriter::writingFinished, this, [=]( bool success ) {
+		if( success == false )
+		{
+			vWarning() << "could not finish writing" << fileName;
+
+			QFile::remove( fileName );
+
+			QMessageBox::critical( nullptr, m_fileTransferFeature.displayName(),
+								   tr( "Could not receive file \"%1\" as it could not be written completely!" ).
+								   arg( fileName ) );
+		}
+		else if( openFileInApplication )
+		{
+			QDesktopServices::openUrl( QUrl::fromLocalFile( fileName ) );
+		}
+		fileWriter->deleteLater();
+	} );
+
+	fileWriter->finish( m_currentFileSize );
+}
+
+
+
+bool FileTransferPlugin::dataChunk( const FeatureMessage& message, QByteArray& data )
+{
+	data = message.argument( DataChunk ).toByteArray();
+
+	if( message.argument( Compressed ).toBool() )
+	{
+		// compressed chunks are never empty so an empty result always indicates corrupt data
+		data = qUncompress( data );
+		if( data.isEmpty() )
+		{
+			vWarning() << "could not decompress chunk" << message.argument( ChunkIndex ).toInt();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+
+void FileTransferPlugin::failTransfer( VeyonWorkerInterface& worker, const QString& errorMessage )
+{
+	if( m_currentArchive )
+	{
+		m_currentArchive->abort();
+		delete m_currentArchive;
+		m_currentArchive = nullptr;
+	}
+
+	// received data can't be trusted so do not keep a partial file for resuming
+	closeFileWriter( true );
+
+	worker.sendFeatureMessageReply( FeatureMessage( m_fileTransferFeature.uid(), FileTransferErrorCommand ).
+									addArgument( TransferId, m_currentTransferId ) );
+
+	m_currentTransferId = QUuid();
+	m_currentFileName.clear();
+
+	QMessageBox::critical( nullptr, m_fileTransferFeature.displayName(), errorMessage );
+}
+
+
+
+void FileTransferPlugin::startReceivingArchive( VeyonWorkerInterface& worker, const FeatureMessage& message )
+{
+	closeFileWriter( false );
+	m_currentFileName.clear();
+	m_currentTransferId = QUuid();
+	m_currentFileSize = -1;
+
+	if( m_currentArchive )
+	{
+		m_currentArchive->abort();
+		delete m_currentArchive;
+		m_currentArchive = nullptr;
+	}
+
+	// TODO: make path configurable
+	const auto directory = QDir::homePath() + QDir::separator() + message.argument( Filename ).toString();
+	const QFileInfo directoryInfo( directory );
+
+	m_currentTransferId = message.argument( TransferId ).toUuid();
+
+	if( directoryInfo.exists() && directoryInfo.isDir() == false )
+	{
+		failTransfer( worker, tr( "Could not receive directory \"%1\" as a file with the same name already exists." ).
+								arg( directory ) );
+		return;
+	}
+
+	m_currentArchive = new ArchiveWriter( directory, message.argument( OverwriteExistingFile ).toBool() );
+	m_currentCompression = message.argument( Compression ).toInt() == ZlibCompression ? ZlibCompression : NoCompression;
+
+	// signal the master that archives are supported and data can be sent
+	worker.sendFeatureMessageReply( FeatureMessage( m_fileTransferFeature.uid(), FileTransferStatusCommand ).
+									addArgument( TransferId, m_currentTransferId ).
+									addArgument( AvailableChunks, QBitArray() ).
+									addArgument( Compression, m_currentCompression ) );
+}
+
+
+
+bool FileTransferPlugin::receiveArchiveData( VeyonWorkerInterface& worker, const QByteArray& data )
+{
+	if( m_currentArchive->write( data ) == false )
+	{
+		failTransfer( worker, tr( "Could not receive directory \"%1\" as the received data is invalid "
+								  "or could not be written." ).arg( m_currentArchive->directory() ) );
+		return false;
+	}
+
+	return true;
+}
+
+
+
+void FileTransferPlugin::finishReceivingArchive( bool openDirectory )
+{
+	const auto directory = m_currentArchive->directory();
+	const auto complete = m_currentArchive->finish();
+	const auto skippedFiles = m_currentArchive->skippedFiles();
+
+	delete m_currentArchive;
+	m_currentArchive = nullptr;
+	m_currentTransferId = QUuid();
+
+	if( complete == false )
+	{
+		vWarning() << "archive incomplete";
+
+		QMessageBox::critical( nullptr, m_fileTransferFeature.displayName(),
+							   tr( "Could not receive directory \"%1\" as it could not be written completely!" ).
+							   arg( directory ) );
+		return;
+	}
+
+	if( skippedFiles > 0 )
+	{
+		QMessageBox::warning( nullptr, m_fileTransferFeature.displayName(),
+							  tr( "%1 file(s) in directory \"%2\" were not received as they already exist "
+								  "or could not be opened for writing." ).arg( skippedFiles ).arg( directory ) );
+	}
+
+	if( openDirectory )
+	{
+		QDesktopServices::openUrl( QUrl::fromLocalFile( directory ) );
+	}
+}
+
+
+
+void FileTransferPlugin::addTransferReplyDevice( QUuid transferId, QIODevice* device )
+{
+	if( device == nullptr )
+	{
+		return;
+	}
+
+	m_transferReplyDevices[transferId] = device;
+
+	// forget about transfers of masters which disconnect in the middle of a transfer
+	connect( device, &QIODevice::aboutToClose,
+			 this, &FileTransferPlugin::removeClosedTransferReplyDevice, Qt::UniqueConnection );
+	connect( device, &QObject::destroyed,
+			 this, &FileTransferPlugin::removeTransferReplyDevice, Qt::UniqueConnection );
+}
+
+
+
+void FileTransferPlugin::removeTransferReplyDevice( QObject* device )
+{
+	for( auto it = m_transferReplyDevices.begin(); it != m_transferReplyDevices.end(); )
+	{
+		// guarded pointers have already been reset when the device is being destroyed
+		if( it.value().isNull() || it.value().data() == device )
+		{
+			it = m_transferReplyDevices.erase( it );
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
+
+
+void FileTransferPlugin::removeClosedTransferReplyDevice()
+{
+	removeTransferReplyDevice( sender() );
+}
+
+
+
 void FileTransferPlugin::startFileTransfer( const QStringList& files, Configuration::Object* userConfigObject,
 											const ComputerControlInterfaceList& interfaces )
 {
@@ -24,13 +24,19 @@
 
 #pragma once
 
+#include <QBitArray>
+#include <QCryptographicHash>
 #include <QFile>
+#include <QHash>
+#include <QSet>
 #include <QUrl>
 
 #include "Configuration/Object.h"
 #include "FeatureProviderInterface.h"
 
+class ArchiveWriter;
 class FileTransferController;
+class FileWriter;
 class FileTransferUserConfiguration;
 
 class FileTransferPlugin : public QObject, FeatureProviderInterface, PluginInterface
@@ -94,13 +100,29 @@ public:
 	bool handleFeatureMessage( VeyonWorkerInterface& worker, const FeatureMessage& message ) override;
 
 	void sendStartMessage( QUuid transferId, const QString& fileName,
-						   bool overwriteExistingFile, const ComputerControlInterfaceList& interfaces );
-	void sendDataMessage( QUuid transferId, const QByteArray& data, const ComputerControlInterfaceList& interfaces );
+						   bool overwriteExistingFile, qint64 fileSize, int chunkSize, const QByteArray& chunkHashes,
+						   bool compressData, const ComputerControlInterfaceList& interfaces );
+	void sendStartArchiveMessage( QUuid transferId, const QString& directoryName,
+								  bool overwriteExistingFiles, qint64 archiveSize,
+								  bool compressData, const ComputerControlInterfaceList& interfaces );
+	void sendDataMessage( QUuid transferId, int chunkIndex, const QByteArray& data, bool compressed,
+						  const ComputerControlInterfaceList& interfaces );
 	void sendCancelMessage( QUuid transferId, const ComputerControlInterfaceList& interfaces );
 	void sendFinishMessage( QUuid transferId, const QString& fileName,
 							bool openFileInApplication, const ComputerControlInterfaceList& interfaces );
 	void sendOpenTransferFolderMessage( const ComputerControlInterfaceList& interfaces );
 
+	static QByteArray computeChunkHashes( const QString& fileName, qint64 chunkSize, qint64 maximumSize = -1 );
+
+	enum CompressionMethod
+	{
+		NoCompression,
+		ZlibCompression
+	};
+
+	static constexpr auto ChunkHashAlgorithm = QCryptographicHash::Md5;
+	static constexpr int ChunkHashSize = 16;
+
 signals:
 	Q_INVOKABLE void acceptSelectedFiles( const QList<QUrl>& fileUrls );
 
@@ -113,6 +135,21 @@ private:
 	void startFileTransfer( const QStringList& files, Configuration::Object* config,
 							const ComputerControlInterfaceList& interfaces );
 
+	void addTransferReplyDevice( QUuid transferId, QIODevice* device );
+	void removeTransferReplyDevice( QObject* device );
+	void removeClosedTransferReplyDevice();
+
+	void startReceivingFile( VeyonWorkerInterface& worker, const FeatureMessage& message );
+	void checkAvailableChunks( VeyonWorkerInterface& worker, const QByteArray& chunkHashes );
+	bool openFileWriter( VeyonWorkerInterface& worker, QIODevice::OpenMode openMode, qint64 preallocateSize = -1 );
+	void closeFileWriter( bool removeFile );
+	void finishFileWriter( bool openFileInApplication );
+	bool dataChunk( const FeatureMessage& message, QByteArray& data );
+	void failTransfer( VeyonWorkerInterface& worker, const QString& errorMessage );
+	void startReceivingArchive( VeyonWorkerInterface& worker, const FeatureMessage& message );
+	bool receiveArchiveData( VeyonWorkerInterface& worker, const QByteArray& data );
+	void finishReceivingArchive( bool openDirectory );
+
 	enum Commands
 	{
 		FileTransferStartCommand,
@@ -120,6 +157,9 @@ private:
 		FileTransferCancelCommand,
 		FileTransferFinishCommand,
 		OpenTransferFolder,
+		FileTransferAcknowledgeCommand,
+		FileTransferStatusCommand,
+		FileTransferErrorCommand,
 		CommandCount
 	};
 
@@ -130,6 +170,15 @@ private:
 		DataChunk,
 		OpenFileInApplication,
 		OverwriteExistingFile,
+		ChunkIndex,
+		FileSize,
+		ChunkSize,
+		ChunkHashes,
+		AvailableChunks,
+		Archive,
+		Compression,
+		Compressed,
+		StatusPending,
 		ArgumentsCount
 	};
 
@@ -140,7 +189,18 @@ private:
 
 	FileTransferController* m_fileTransferController;
 
-	QFile m_currentFile;
+	QHash<QUuid, MessageContext::IODevice> m_transferReplyDevices;
+
+	// files which have been created by interrupted transfers and may be resumed or overwritten
+	QSet<QString> m_partialFiles;
+
+	QString m_currentFileName;
+	bool m_overwriteCurrentFile;
+	FileWriter* m_currentFileWriter;
 	QUuid m_currentTransferId;
+	qint64 m_currentFileSize;
+	qint64 m_currentChunkSize;
+	ArchiveWriter* m_currentArchive;
+	CompressionMethod m_currentCompression;
 
 };
@@ -0,0 +1,210 @@
+/*
+ * FileWriter.cpp - implementation of FileWriter class
+ *
+ * Copyright (c) 2018-2019 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "FileWriter.h"
+#include "VeyonCore.h"
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#endif
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+
+FileWriter::FileWriter( const QString& fileName, QObject* parent ) :
+	QThread( parent ),
+	m_file( fileName ),
+	m_preallocateSize( -1 ),
+	m_queueMutex(),
+	m_queueNotEmpty(),
+	m_queue(),
+	m_canceled( false ),
+	m_failed( false )
+{
+}
+
+
+
+FileWriter::~FileWriter()
+{
+	if( isRunning() )
+	{
+		cancel( false );
+	}
+}
+
+
+
+bool FileWriter::open( QIODevice::OpenMode openMode, qint64 preallocateSize )
+{
+	if( m_file.open( openMode ) == false )
+	{
+		return false;
+	}
+
+	m_preallocateSize = preallocateSize;
+
+	start();
+
+	return true;
+}
+
+
+
+void FileWriter::write( qint64 offset, const QByteArray& data, int chunkIndex )
+{
+	// never block the caller - the sender is throttled as chunks are only acknowledged once written to disk
+	QMutexLocker locker( &m_queueMutex );
+
+	m_queue.enqueue( { offset, data, chunkIndex, false } );
+	m_queueNotEmpty.wakeOne();
+}
+
+
+
+void FileWriter::finish( qint64 fileSize )
+{
+	QMutexLocker locker( &m_queueMutex );
+
+	m_queue.enqueue( { fileSize, {}, -1, true } );
+	m_queueNotEmpty.wakeOne();
+}
+
+
+
+void FileWriter::cancel( bool removeFile )
+{
+	m_queueMutex.lock();
+	m_canceled = true;
+	m_queue.clear();
+	m_queueNotEmpty.wakeAll();
+	m_queueMutex.unlock();
+
+	wait();
+
+	if( removeFile )
+	{
+		m_file.remove();
+	}
+	else
+	{
+		m_file.close();
+	}
+}
+
+
+
+void FileWriter::run()
+{
+	preallocate();
+
+	forever
+	{
+		m_queueMutex.lock();
+
+		while( m_queue.isEmpty() && m_canceled == false )
+		{
+			m_queueNotEmpty.wait( &m_queueMutex );
+		}
+
+		if( m_canceled )
+		{
+			m_queueMutex.unlock();
+			return;
+		}
+
+		const auto operation = m_queue.dequeue();
+		m_queueMutex.unlock();
+
+		if( operation.finish )
+		{
+			emit writingFinished( finishFile( operation.offset ) );
+			return;
+		}
+
+		if( m_failed )
+		{
+			continue;
+		}
+
+		if( ( operation.offset >= 0 && m_file.seek( operation.offset ) == false ) ||
+			m_file.write( operation.data ) != operation.data.size() )
+		{
+			vWarning() << "could not write to" << m_file.fileName() << m_file.errorString();
+
+			// do not acknowledge this or any further chunk so the file is never reported as complete
+			m_failed = true;
+			emit writingFailed();
+			continue;
+		}
+
+		if( operation.chunkIndex >= 0 )
+		{
+			emit chunkWritten( operation.chunkIndex );
+		}
+	}
+}
+
+
+
+void FileWriter::preallocate()
+{
+#ifdef Q_OS_LINUX
+	// reserve disk space for the whole file upfront to avoid fragmentation without changing
+	// its size so that resumed transfers and the final size check are not affected
+	if( m_preallocateSize > 0 &&
+		fallocate( m_file.handle(), FALLOC_FL_KEEP_SIZE, 0, m_preallocateSize ) != 0 )
+	{
+		vDebug() << "could not preallocate" << m_preallocateSize << "bytes for" << m_file.fileName();
+	}
+#endif
+}
+
+
+
+bool FileWriter::finishFile( qint64 fileSize )
+{
+	auto success = m_failed == false && m_file.flush();
+
+	// discard any trailing data of a previous, larger file
+	if( fileSize >= 0 && m_file.size() != fileSize )
+	{
+		success &= m_file.resize( fileSize );
+	}
+
+	// make sure all data has been written to disk before the file is reported as received
+#ifdef Q_OS_WIN
+	success &= _commit( m_file.handle() ) == 0;
+#else
+	success &= fsync( m_file.handle() ) == 0;
+#endif
+
+	m_file.close();
+
+	return success;
+}
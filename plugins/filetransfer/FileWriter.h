@@ -0,0 +1,82 @@
+/*
+ * FileWriter.h - declaration of FileWriter class
+ *
+ * Copyright (c) 2018-2019 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <QFile>
+#include <QMutex>
+#include <QQueue>
+#include <QThread>
+#include <QWaitCondition>
+
+// writes received chunks to a file in a background thread so that disk I/O does not block the user session
+class FileWriter : public QThread
+{
+	Q_OBJECT
+public:
+	explicit FileWriter( const QString& fileName, QObject* parent = nullptr );
+	~FileWriter() override;
+
+	bool open( QIODevice::OpenMode openMode, qint64 preallocateSize = -1 );
+
+	QString fileName() const
+	{
+		return m_file.fileName();
+	}
+
+	void write( qint64 offset, const QByteArray& data, int chunkIndex );
+	void finish( qint64 fileSize );
+	void cancel( bool removeFile );
+
+signals:
+	void chunkWritten( int chunkIndex );
+	void writingFailed();
+	void writingFinished( bool success );
+
+private:
+	struct Operation
+	{
+		qint64 offset;
+		QByteArray data;
+		int chunkIndex;
+		bool finish;
+	};
+
+	void run() override;
+
+	void preallocate();
+	bool finishFile( qint64 fileSize );
+
+	QFile m_file;
+	qint64 m_preallocateSize;
+
+	QMutex m_queueMutex;
+	QWaitCondition m_queueNotEmpty;
+	QQueue<Operation> m_queue;
+	bool m_canceled;
+
+	// set by the writer thread once writing failed - all further chunks are discarded then
+	bool m_failed;
+
+};
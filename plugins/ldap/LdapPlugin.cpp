@@ -22,6 +22,8 @@
  *
  */
 
+#include <QMetaEnum>
+
 #include "CommandLineIO.h"
 #include "ConfigurationManager.h"
 #include "LdapNetworkObjectDirectory.h"
@@ -39,6 +41,7 @@ LdapPlugin::LdapPlugin( QObject* parent ) :
 	m_commands( {
 { QStringLiteral("autoconfigurebasedn"), tr( "Auto-configure the base DN via naming context" ) },
 { QStringLiteral("query"), tr( "Query objects from LDAP directory" ) },
+{ QStringLiteral("cachestatistics"), tr( "Show statistics of LDAP lookup cache" ) },
 { QStringLiteral("help"), tr( "Show help about command" ) },
 				} )
 {
@@ -248,6 +251,55 @@ CommandLinePluginInterface::RunResult LdapPlugin::handle_query( const QStringLis
 
 
 
+CommandLinePluginInterface::RunResult LdapPlugin::handle_cachestatistics( const QStringList& arguments )
+{
+	const auto userName = arguments.value( 0 );
+	const auto hostName = arguments.value( 1 );
+	const auto repetitions = qMax( 1, arguments.value( 2, QStringLiteral("2") ).toInt() );
+
+	auto& directory = ldapDirectory();
+
+	// perform the same lookups as access control does for an incoming connection
+	for( int i = 0; i < repetitions; ++i )
+	{
+		if( userName.isEmpty() == false )
+		{
+			const auto userDn = directory.users( userName ).value( 0 );
+			if( userDn.isEmpty() == false )
+			{
+				directory.groupsOfUser( userDn );
+				directory.userLoginName( userDn );
+			}
+		}
+
+		if( hostName.isEmpty() == false )
+		{
+			const auto computerDn = directory.computerObjectFromHost( hostName );
+			if( computerDn.isEmpty() == false )
+			{
+				directory.groupsOfComputer( computerDn );
+				directory.locationsOfComputer( computerDn );
+			}
+		}
+	}
+
+	const auto queryTypes = QMetaEnum::fromType<LdapDirectory::CacheQueryType>();
+
+	printf( "%-24s %10s %14s %10s\n", "Query type", "Hits", "Negative hits", "Misses" );
+
+	for( int i = 0; i < static_cast<int>( LdapDirectory::CacheQueryType::Count ); ++i )
+	{
+		const auto statistics = directory.cacheStatistics( static_cast<LdapDirectory::CacheQueryType>( i ) );
+		printf( "%-24s %10llu %14llu %10llu\n", queryTypes.valueToKey( i ),
+				static_cast<unsigned long long>( statistics.hits ),
+				static_cast<unsigned long long>( statistics.negativeHits ),
+				static_cast<unsigned long long>( statistics.misses ) );
+	}
+
+	return Successful;
+}
+
+
 
 CommandLinePluginInterface::RunResult LdapPlugin::handle_help( const QStringList& arguments )
 {
@@ -276,6 +328,18 @@ CommandLinePluginInterface::RunResult LdapPlugin::handle_help( const QStringList
 				"\n" );
 		return NoResult;
 	}
+	else if( command == QLatin1String("cachestatistics") )
+	{
+		printf( "\n"
+				"ldap cachestatistics [<user login name> [<computer host> [<repetitions>]]]\n"
+				"\n"
+				"Performs the LDAP lookups used by access control for the given user and/or\n"
+				"computer repeatedly (twice by default) and prints hit and miss counters of\n"
+				"the LDAP lookup cache of this command per query type. Counters of running\n"
+				"services are logged periodically at debug level instead.\n"
+				"\n" );
+		return NoResult;
+	}
 
 	return InvalidCommand;
 }
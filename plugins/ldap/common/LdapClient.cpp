@@ -22,12 +22,15 @@
  *
  */
 
+#include <QTimer>
+
 #include "LdapConfiguration.h"
 #include "LdapClient.h"
 
 #include <ldap.h>
 
 #include "ldapconnection.h"
+#include "ldapcontrol.h"
 #include "ldapoperation.h"
 #include "ldapserver.h"
 
@@ -51,8 +54,20 @@ LdapClient::LdapClient( const LdapConfiguration& configuration, const QUrl& url,
 	m_configuration( configuration ),
 	m_server( new KLDAP::LdapServer ),
 	m_connection( new KLDAP::LdapConnection ),
-	m_operation( new KLDAP::LdapOperation )
+	m_operation( new KLDAP::LdapOperation ),
+	m_queryTimer( new QTimer( this ) )
 {
+	m_queryTimer->setInterval( QueryProcessingInterval );
+
+	connect( m_queryTimer, &QTimer::timeout, this, [this]() {
+		processQueries( 0 );
+		if( std::none_of( m_queries.cbegin(), m_queries.cend(),
+						  []( const Query& query ) { return query.streamed; } ) )
+		{
+			m_queryTimer->stop();
+		}
+	} );
+
 	connectAndBind( url );
 }
 
@@ -94,95 +109,116 @@ QString LdapClient::errorDescription() const
 
 LdapClient::Objects LdapClient::queryObjects( const QString& dn, const QStringList& attributes,
 											  const QString& filter, LdapClient::Scope scope )
+{
+	const auto entries = endQueryObjects( beginQueryObjects( dn, attributes, filter, scope ) );
+
+	vDebug() << "results:" << entries;
+
+	return entries;
+}
+
+
+
+/*!
+ * \brief Starts a search without waiting for its results
+ * \return ID of the query or -1 on error
+ *
+ * Found objects are delivered page by page via objectsReceived() while processing the
+ * query in the background. queryFinished() is emitted after the last page has been delivered.
+ */
+int LdapClient::queryObjectsAsync( const QString& dn, const QStringList& attributes,
+								   const QString& filter, LdapClient::Scope scope )
 {
 	vDebug() << "called with" << dn << attributes << filter << scope;
 
 	if( m_state != Bound && reconnect() == false )
 	{
 		vCritical() << "not bound to server!";
-		return {};
+		return -1;
 	}
 
 	if( dn.isEmpty() )
 	{
 		vCritical() << "DN is empty!";
-		return {};
+		return -1;
 	}
 
 	if( attributes.isEmpty() )
 	{
 		vCritical() << "attributes empty!";
-		return {};
+		return -1;
 	}
 
-	Objects entries;
+	const auto queryId = startQuery( dn, attributes, filter, scope, true );
+	if( queryId >= 0 )
+	{
+		m_queryTimer->start();
+	}
 
-	int result = -1;
-	auto id = m_operation->search( KLDAP::LdapDN( dn ), kldapUrlScope( scope ), filter, QStringList( attributes ) );
+	return queryId;
+}
 
-	if( id != -1 )
-	{
-		auto realAttributeNames = attributes;
-		for( auto& attribute : realAttributeNames )
-		{
-			attribute = attribute.toLower();
-		}
 
-		auto isFirstResult = true;
 
-		while( ( result = m_operation->waitForResult( id, LdapQueryTimeout ) ) == KLDAP::LdapOperation::RES_SEARCH_ENTRY )
-		{
-			if( isFirstResult )
-			{
-				isFirstResult = false;
+/*!
+ * \brief Starts a search whose results are collected until endQueryObjects() is called
+ * \return ID of the query or -1 on error
+ *
+ * Starting multiple queries before ending them allows all searches to proceed
+ * simultaneously on the same connection.
+ */
+int LdapClient::beginQueryObjects( const QString& dn, const QStringList& attributes,
+								   const QString& filter, LdapClient::Scope scope )
+{
+	vDebug() << "called with" << dn << attributes << filter << scope;
 
-				// match attribute name from result with requested attribute name in order
-				// to keep result aggregation below case-insensitive
-				const auto attributes = m_operation->object().attributes();
-				for( auto it = attributes.constBegin(), end = attributes.constEnd(); it != end; ++it )
-				{
-					for( auto& attribute : realAttributeNames )
-					{
-						if( QString::compare( it.key().toLower(), attribute, Qt::CaseInsensitive ) == 0 )
-						{
-							attribute = it.key();
-							break;
-						}
-					}
-				}
-			}
+	if( m_state != Bound && reconnect() == false )
+	{
+		vCritical() << "not bound to server!";
+		return -1;
+	}
 
-			// convert result list from type QList<QByteArray> to QStringList
-			const auto dn = m_operation->object().dn().toString();
-			for( const auto& attribute : realAttributeNames )
-			{
-				const auto values = m_operation->object().values( attribute );
-				for( const auto& value : values )
-				{
-					entries[dn][attribute] += QString::fromUtf8( value );
-				}
-			}
-		}
+	if( dn.isEmpty() )
+	{
+		vCritical() << "DN is empty!";
+		return -1;
+	}
 
-		vDebug() << "results:" << entries;
+	if( attributes.isEmpty() )
+	{
+		vCritical() << "attributes empty!";
+		return -1;
 	}
 
-	if( result == -1 )
+	return startQuery( dn, attributes, filter, scope, false );
+}
+
+
+
+LdapClient::Objects LdapClient::endQueryObjects( int queryId )
+{
+	if( waitForQuery( queryId ) == false )
 	{
-		vWarning() << "LDAP search failed with code" << m_connection->ldapErrorCode();
+		++m_failedQueryCount;
+	}
+
+	return m_queries.take( queryId ).objects;
+}
 
-		if( m_state == Bound && m_queryRetry == false )
+
+
+void LdapClient::abandonQuery( int queryId )
+{
+	const auto query = m_queries.find( queryId );
+	if( query != m_queries.end() )
+	{
+		if( query->state == Query::State::Running )
 		{
-			// close connection and try again
-			m_queryRetry = true;
-			m_state = Disconnected;
-			entries = queryObjects( dn, attributes, filter, scope );
-			m_queryRetry = false;
+			m_operation->abandon( query->operationId );
 		}
-	}
-
-	return entries;
 
+		m_queries.erase( query );
+	}
 }
 
 
@@ -195,6 +231,7 @@ QStringList LdapClient::queryAttributeValues( const QString& dn, const QString&
 	if( m_state != Bound && reconnect() == false )
 	{
 		vCritical() << "not bound to server!";
+		++m_failedQueryCount;
 		return {};
 	}
 
@@ -202,68 +239,29 @@ QStringList LdapClient::queryAttributeValues( const QString& dn, const QString&
 		attribute.contains( QLatin1String("namingcontext"), Qt::CaseInsensitive ) == false )
 	{
 		vCritical() << "DN is empty!";
+		++m_failedQueryCount;
 		return {};
 	}
 
 	if( attribute.isEmpty() )
 	{
 		vCritical() << "attribute is empty!";
+		++m_failedQueryCount;
 		return {};
 	}
 
 	QStringList entries;
 
-	int result = -1;
-	int id = m_operation->search( KLDAP::LdapDN( dn ), kldapUrlScope( scope ), filter, QStringList( attribute ) );
-
-	if( id != -1 )
+	const auto objects = endQueryObjects( startQuery( dn, { attribute }, filter, scope, false ) );
+	for( const auto& object : objects )
 	{
-		bool isFirstResult = true;
-		QString realAttributeName = attribute.toLower();
-
-		while( ( result = m_operation->waitForResult( id, LdapQueryTimeout ) ) == KLDAP::LdapOperation::RES_SEARCH_ENTRY )
+		for( const auto& values : object )
 		{
-			if( isFirstResult )
-			{
-				isFirstResult = false;
-
-				// match attribute name from result with requested attribute name in order
-				// to keep result aggregation below case-insensitive
-				const auto attributes = m_operation->object().attributes();
-				for( auto it = attributes.constBegin(), end = attributes.constEnd(); it != end; ++it )
-				{
-					if( it.key().toLower() == realAttributeName )
-					{
-						realAttributeName = it.key();
-						break;
-					}
-				}
-			}
-
-			// convert result list from type QList<QByteArray> to QStringList
-			const auto values = m_operation->object().values( realAttributeName );
-			for( const auto& value : values )
-			{
-				entries += QString::fromUtf8( value );
-			}
+			entries += values;
 		}
-
-		vDebug() << "results:" << entries;
 	}
 
-	if( result == -1 )
-	{
-		vWarning() << "LDAP search failed with code" << m_connection->ldapErrorCode();
-
-		if( m_state == Bound && m_queryRetry == false )
-		{
-			// close connection and try again
-			m_queryRetry = true;
-			m_state = Disconnected;
-			entries = queryAttributeValues( dn, attribute, filter, scope );
-			m_queryRetry = false;
-		}
-	}
+	vDebug() << "results:" << entries;
 
 	return entries;
 }
@@ -277,42 +275,21 @@ QStringList LdapClient::queryDistinguishedNames( const QString& dn, const QStrin
 	if( m_state != Bound && reconnect() == false )
 	{
 		vCritical() << "not bound to server!";
+		++m_failedQueryCount;
 		return {};
 	}
 
 	if( dn.isEmpty() )
 	{
 		vCritical() << "DN is empty!";
+		++m_failedQueryCount;
 		return {};
 	}
 
-	QStringList distinguishedNames;
+	// request no attributes at all (RFC 4511, section 4.5.1.8) as only the DNs are of interest
+	const auto distinguishedNames = endQueryObjects( startQuery( dn, { QStringLiteral("1.1") }, filter, scope, false ) ).keys();
 
-	int result = -1;
-	int id = m_operation->search( KLDAP::LdapDN( dn ), kldapUrlScope( scope ), filter, QStringList() );
-
-	if( id != -1 )
-	{
-		while( ( result = m_operation->waitForResult( id, LdapQueryTimeout ) ) == KLDAP::LdapOperation::RES_SEARCH_ENTRY )
-		{
-			distinguishedNames += m_operation->object().dn().toString();
-		}
-		vDebug() << "results" << distinguishedNames;
-	}
-
-	if( result == -1 )
-	{
-		vWarning() << "LDAP search failed with code" << m_connection->ldapErrorCode();
-
-		if( m_state == Bound && m_queryRetry == false )
-		{
-			// close connection and try again
-			m_queryRetry = true;
-			m_state = Disconnected;
-			distinguishedNames = queryDistinguishedNames( dn, filter, scope );
-			m_queryRetry = false;
-		}
-	}
+	vDebug() << "results" << distinguishedNames;
 
 	return distinguishedNames;
 }
@@ -535,6 +512,340 @@ void LdapClient::initTLS()
 
 
 
+int LdapClient::startQuery( const QString& dn, const QStringList& attributes, const QString& filter,
+							Scope scope, bool streamed )
+{
+	Query query;
+	query.dn = dn;
+	query.attributes = attributes;
+	query.filter = filter;
+	query.scope = scope;
+	query.streamed = streamed;
+	// retrieve results in pages (RFC 2696) so that server side size limits do not apply
+	query.paged = scope != Scope::Base;
+
+	const auto queryId = ++m_lastQueryId;
+	m_queries[queryId] = query;
+
+	if( startOperation( m_queries[queryId] ) == false &&
+		handleQueryError( queryId ) == false )
+	{
+		m_queries.remove( queryId );
+		return -1;
+	}
+
+	return queryId;
+}
+
+
+
+bool LdapClient::startOperation( Query& query )
+{
+	if( query.paged )
+	{
+		// send control as non-critical so that servers without support for paged results
+		// ignore it and return all results at once instead of failing the search
+		auto pageControl = KLDAP::LdapControl::createPageControl( LdapPageSize, query.pageCookie );
+		pageControl.setCritical( false );
+		m_operation->setServerControls( { pageControl } );
+	}
+
+	query.operationId = m_operation->search( KLDAP::LdapDN( query.dn ), kldapUrlScope( query.scope ),
+											 query.filter, query.attributes );
+	query.lastActivity.restart();
+
+	if( query.paged )
+	{
+		m_operation->setServerControls( {} );
+	}
+
+	if( query.operationId == -1 )
+	{
+		vWarning() << "LDAP search failed with code" << m_connection->ldapErrorCode();
+		return false;
+	}
+
+	return true;
+}
+
+
+
+void LdapClient::processQueries( int timeout )
+{
+	const auto queryIds = m_queries.keys();
+
+	bool processed = false;
+	for( auto queryId : queryIds )
+	{
+		processed |= processQuery( queryId, 0 );
+	}
+
+	// nothing received so far so wait for any results of the first running query
+	if( processed == false && timeout > 0 )
+	{
+		for( auto queryId : queryIds )
+		{
+			const auto query = m_queries.constFind( queryId );
+			if( query != m_queries.constEnd() && query->state == Query::State::Running )
+			{
+				processQuery( queryId, timeout );
+				break;
+			}
+		}
+	}
+}
+
+
+
+bool LdapClient::processQuery( int queryId, int timeout )
+{
+	auto query = m_queries.find( queryId );
+	if( query == m_queries.end() || query->state != Query::State::Running )
+	{
+		return false;
+	}
+
+	auto result = m_operation->waitForResult( query->operationId, timeout );
+	if( result == 0 )
+	{
+		if( query->lastActivity.elapsed() > LdapQueryTimeout )
+		{
+			vWarning() << "LDAP search timed out";
+			m_operation->abandon( query->operationId );
+			finishQuery( queryId, Query::State::Failed );
+			return true;
+		}
+
+		return false;
+	}
+
+	while( result == KLDAP::LdapOperation::RES_SEARCH_ENTRY )
+	{
+		addQueryResult( *query );
+		result = m_operation->waitForResult( query->operationId, 0 );
+	}
+
+	query->lastActivity.restart();
+
+	if( result == 0 )
+	{
+		// more results pending
+		return true;
+	}
+
+	if( result != KLDAP::LdapOperation::RES_SEARCH_RESULT )
+	{
+		vWarning() << "LDAP search failed with code" << m_connection->ldapErrorCode();
+
+		if( handleQueryError( queryId ) == false )
+		{
+			finishQuery( queryId, Query::State::Failed );
+		}
+
+		return true;
+	}
+
+	QByteArray pageCookie;
+	const auto controls = m_operation->controls();
+	for( const auto& control : controls )
+	{
+		if( control.parsePageControl( pageCookie ) >= 0 )
+		{
+			break;
+		}
+	}
+
+	if( query->streamed && query->objects.isEmpty() == false )
+	{
+		const auto objects = query->objects;
+		query->objects.clear();
+		query->delivered = true;
+
+		emit objectsReceived( queryId, objects );
+
+		// query might have been abandoned by a connected slot
+		query = m_queries.find( queryId );
+		if( query == m_queries.end() || query->state != Query::State::Running )
+		{
+			return true;
+		}
+	}
+
+	if( query->paged && pageCookie.isEmpty() == false )
+	{
+		// request next page
+		query->pageCookie = pageCookie;
+		if( startOperation( *query ) == false &&
+			handleQueryError( queryId ) == false )
+		{
+			finishQuery( queryId, Query::State::Failed );
+		}
+	}
+	else
+	{
+		finishQuery( queryId, Query::State::Succeeded );
+	}
+
+	return true;
+}
+
+
+
+void LdapClient::addQueryResult( Query& query )
+{
+	const auto object = m_operation->object();
+
+	if( query.resultAttributes.isEmpty() )
+	{
+		// match attribute name from result with requested attribute name in order
+		// to keep result aggregation below case-insensitive
+		query.resultAttributes = query.attributes;
+
+		const auto attributes = object.attributes();
+		for( auto it = attributes.constBegin(), end = attributes.constEnd(); it != end; ++it )
+		{
+			for( auto& attribute : query.resultAttributes )
+			{
+				if( QString::compare( it.key(), attribute, Qt::CaseInsensitive ) == 0 )
+				{
+					attribute = it.key();
+					break;
+				}
+			}
+		}
+	}
+
+	auto& entry = query.objects[object.dn().toString()];
+
+	// convert result list from type QList<QByteArray> to QStringList
+	for( const auto& attribute : qAsConst( query.resultAttributes ) )
+	{
+		const auto values = object.values( attribute );
+		if( values.isEmpty() == false )
+		{
+			auto& entryValues = entry[attribute];
+			entryValues.reserve( entryValues.size() + values.size() );
+			for( const auto& value : values )
+			{
+				entryValues += QString::fromUtf8( value );
+			}
+		}
+	}
+}
+
+
+
+bool LdapClient::handleQueryError( int queryId )
+{
+	const auto query = m_queries.constFind( queryId );
+	if( query == m_queries.constEnd() ||
+		m_state != Bound || query->retried || query->delivered )
+	{
+		return false;
+	}
+
+	// close connection and try again - as this invalidates all pending operations,
+	// restart all other running queries as well
+	if( reconnect() == false )
+	{
+		return false;
+	}
+
+	restartQueries();
+
+	const auto restartedQuery = m_queries.constFind( queryId );
+
+	return restartedQuery != m_queries.constEnd() && restartedQuery->state == Query::State::Running;
+}
+
+
+
+void LdapClient::restartQueries()
+{
+	const auto queryIds = m_queries.keys();
+
+	for( auto queryId : queryIds )
+	{
+		auto query = m_queries.find( queryId );
+		if( query == m_queries.end() || query->state != Query::State::Running )
+		{
+			continue;
+		}
+
+		// results which have been delivered already can't be retrieved again consistently
+		if( query->retried || query->delivered )
+		{
+			finishQuery( queryId, Query::State::Failed );
+			continue;
+		}
+
+		query->retried = true;
+		query->pageCookie.clear();
+		query->resultAttributes.clear();
+		query->objects.clear();
+
+		if( startOperation( *query ) == false )
+		{
+			finishQuery( queryId, Query::State::Failed );
+		}
+	}
+}
+
+
+
+void LdapClient::finishQuery( int queryId, Query::State state )
+{
+	const auto query = m_queries.find( queryId );
+	if( query == m_queries.end() || query->state != Query::State::Running )
+	{
+		return;
+	}
+
+	query->state = state;
+
+	// results of streamed queries have been delivered already
+	if( query->streamed )
+	{
+		if( state != Query::State::Succeeded )
+		{
+			++m_failedQueryCount;
+		}
+
+		const auto objects = query->objects;
+		m_queries.erase( query );
+
+		if( objects.isEmpty() == false )
+		{
+			emit objectsReceived( queryId, objects );
+		}
+
+		emit queryFinished( queryId, state == Query::State::Succeeded );
+	}
+}
+
+
+
+bool LdapClient::waitForQuery( int queryId )
+{
+	for( ;; )
+	{
+		const auto query = m_queries.constFind( queryId );
+		if( query == m_queries.constEnd() )
+		{
+			return false;
+		}
+
+		if( query->state != Query::State::Running )
+		{
+			return query->state == Query::State::Succeeded;
+		}
+
+		processQueries( QueryProcessingInterval );
+	}
+}
+
+
+
 bool LdapClient::reconnect()
 {
 	m_connection->close();
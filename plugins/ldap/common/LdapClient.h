@@ -24,6 +24,8 @@
 
 #pragma once
 
+#include <QElapsedTimer>
+#include <QHash>
 #include <QObject>
 #include <QUrl>
 
@@ -36,6 +38,7 @@ class LdapServer;
 }
 
 class LdapConfiguration;
+class QTimer;
 
 class LDAP_COMMON_EXPORT LdapClient : public QObject
 {
@@ -89,8 +92,19 @@ public:
 	QString errorString() const;
 	QString errorDescription() const;
 
+	// increased whenever a query fails so callers can tell errors from empty results
+	quint64 failedQueryCount() const
+	{
+		return m_failedQueryCount;
+	}
+
 	Objects queryObjects( const QString& dn, const QStringList& attributes, const QString& filter, Scope scope );
 
+	int queryObjectsAsync( const QString& dn, const QStringList& attributes, const QString& filter, Scope scope );
+	int beginQueryObjects( const QString& dn, const QStringList& attributes, const QString& filter, Scope scope );
+	Objects endQueryObjects( int queryId );
+	void abandonQuery( int queryId );
+
 	QStringList queryAttributeValues( const QString &dn, const QString &attribute,
 									  const QString& filter = QStringLiteral( "(objectclass=*)" ),
 									  Scope scope = Scope::Base );
@@ -121,9 +135,49 @@ public:
 
 	static QStringList toRDNs( const QString& dn );
 
+signals:
+	void objectsReceived( int queryId, const LdapClient::Objects& objects );
+	void queryFinished( int queryId, bool success );
+
 private:
 	static constexpr int LdapQueryTimeout = 3000;
 	static constexpr int LdapConnectionTimeout = 60*1000;
+	static constexpr int LdapPageSize = 500;
+	static constexpr int QueryProcessingInterval = 10;
+
+	struct Query
+	{
+		enum class State {
+			Running,
+			Succeeded,
+			Failed
+		};
+
+		QString dn;
+		QStringList attributes;
+		QString filter;
+		Scope scope{Scope::Base};
+		bool streamed{false};
+		bool paged{false};
+		bool retried{false};
+		bool delivered{false};
+		int operationId{-1};
+		QByteArray pageCookie;
+		QStringList resultAttributes;
+		Objects objects;
+		QElapsedTimer lastActivity;
+		State state{State::Running};
+	};
+
+	int startQuery( const QString& dn, const QStringList& attributes, const QString& filter, Scope scope, bool streamed );
+	bool startOperation( Query& query );
+	void processQueries( int timeout );
+	bool processQuery( int queryId, int timeout );
+	void addQueryResult( Query& query );
+	bool handleQueryError( int queryId );
+	void restartQueries();
+	void finishQuery( int queryId, Query::State state );
+	bool waitForQuery( int queryId );
 
 	bool reconnect();
 	bool connectAndBind( const QUrl& url );
@@ -144,7 +198,10 @@ private:
 
 	State m_state = Disconnected;
 
-	bool m_queryRetry = false;
+	QHash<int, Query> m_queries;
+	int m_lastQueryId = 0;
+	QTimer* m_queryTimer;
+	quint64 m_failedQueryCount = 0;
 
 	QString m_baseDn;
 	QString m_namingContextAttribute;
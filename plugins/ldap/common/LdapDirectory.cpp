@@ -65,6 +65,9 @@ LdapDirectory::LdapDirectory( const LdapConfiguration& configuration, QObject* p
 	m_computerLocationsByAttribute = m_configuration.computerLocationsByAttribute();
 	m_computerLocationAttribute = m_configuration.computerLocationAttribute();
 
+	m_cache.setMaxCost( CacheSize );
+	m_cacheStatistics.resize( static_cast<int>( CacheQueryType::Count ) );
+	m_cacheTimer.start();
 }
 
 
@@ -142,6 +145,8 @@ void LdapDirectory::disableAttributes()
 	m_computerDisplayNameAttribute.clear();
 	m_computerHostNameAttribute.clear();
 	m_computerMacAddressAttribute.clear();
+
+	invalidateCache();
 }
 
 
@@ -156,6 +161,8 @@ void LdapDirectory::disableFilters()
 	m_computersFilter.clear();
 	m_computerGroupsFilter.clear();
 	m_computerContainersFilter.clear();
+
+	invalidateCache();
 }
 
 
@@ -163,9 +170,19 @@ void LdapDirectory::disableFilters()
 
 QStringList LdapDirectory::users( const QString& filterValue )
 {
-	return m_client.queryDistinguishedNames( usersDn(),
-											 LdapClient::constructQueryFilter( m_userLoginNameAttribute, filterValue, m_usersFilter ),
-											 m_defaultSearchScope );
+	const auto query = [=]() {
+		return m_client.queryDistinguishedNames( usersDn(),
+												 LdapClient::constructQueryFilter( m_userLoginNameAttribute, filterValue, m_usersFilter ),
+												 m_defaultSearchScope );
+	};
+
+	// only cache lookups of specific users (e.g. during access control)
+	if( filterValue.isEmpty() )
+	{
+		return query();
+	}
+
+	return cachedQuery( CacheQueryType::Users, filterValue, query );
 }
 
 
@@ -264,62 +281,70 @@ QStringList LdapDirectory::groupMembers( const QString& groupDn )
 
 QStringList LdapDirectory::groupsOfUser( const QString& userDn )
 {
-	const auto userId = groupMemberUserIdentification( userDn );
-	if( m_groupMemberAttribute.isEmpty() || userId.isEmpty() )
-	{
-		return {};
-	}
+	return cachedQuery( CacheQueryType::GroupsOfUser, userDn, [=]() -> QStringList {
+		const auto userId = groupMemberUserIdentification( userDn );
+		if( m_groupMemberAttribute.isEmpty() || userId.isEmpty() )
+		{
+			return {};
+		}
 
-	return m_client.queryDistinguishedNames( groupsDn(),
-											 LdapClient::constructQueryFilter( m_groupMemberAttribute, userId, m_userGroupsFilter ),
-											 m_defaultSearchScope );
+		return m_client.queryDistinguishedNames( groupsDn(),
+												 LdapClient::constructQueryFilter( m_groupMemberAttribute, userId, m_userGroupsFilter ),
+												 m_defaultSearchScope );
+	} );
 }
 
 
 
 QStringList LdapDirectory::groupsOfComputer( const QString& computerDn )
 {
-	const auto computerId = groupMemberComputerIdentification( computerDn );
-	if( m_groupMemberAttribute.isEmpty() || computerId.isEmpty() )
-	{
-		return {};
-	}
+	return cachedQuery( CacheQueryType::GroupsOfComputer, computerDn, [=]() -> QStringList {
+		const auto computerId = groupMemberComputerIdentification( computerDn );
+		if( m_groupMemberAttribute.isEmpty() || computerId.isEmpty() )
+		{
+			return {};
+		}
 
-	return m_client.queryDistinguishedNames( computerGroupsDn(),
-											 LdapClient::constructQueryFilter( m_groupMemberAttribute, computerId, m_computerGroupsFilter ),
-											 m_defaultSearchScope );
+		return m_client.queryDistinguishedNames( computerGroupsDn(),
+												 LdapClient::constructQueryFilter( m_groupMemberAttribute, computerId, m_computerGroupsFilter ),
+												 m_defaultSearchScope );
+	} );
 }
 
 
 
 QStringList LdapDirectory::locationsOfComputer( const QString& computerDn )
 {
-	if( m_computerLocationsByAttribute )
-	{
-		return m_client.queryAttributeValues( computerDn, m_computerLocationAttribute );
-	}
-	else if( m_computerLocationsByContainer )
-	{
-		return m_client.queryAttributeValues( LdapClient::parentDn( computerDn ), m_locationNameAttribute );
-	}
+	return cachedQuery( CacheQueryType::LocationsOfComputer, computerDn, [=]() -> QStringList {
+		if( m_computerLocationsByAttribute )
+		{
+			return m_client.queryAttributeValues( computerDn, m_computerLocationAttribute );
+		}
+		else if( m_computerLocationsByContainer )
+		{
+			return m_client.queryAttributeValues( LdapClient::parentDn( computerDn ), m_locationNameAttribute );
+		}
 
-	const auto computerId = groupMemberComputerIdentification( computerDn );
-	if( m_groupMemberAttribute.isEmpty() || computerId.isEmpty() )
-	{
-		return {};
-	}
+		const auto computerId = groupMemberComputerIdentification( computerDn );
+		if( m_groupMemberAttribute.isEmpty() || computerId.isEmpty() )
+		{
+			return {};
+		}
 
-	return m_client.queryAttributeValues( computerGroupsDn(),
-										  m_locationNameAttribute,
-										  LdapClient::constructQueryFilter( m_groupMemberAttribute, computerId, m_computerGroupsFilter ),
-										  m_defaultSearchScope );
+		return m_client.queryAttributeValues( computerGroupsDn(),
+											  m_locationNameAttribute,
+											  LdapClient::constructQueryFilter( m_groupMemberAttribute, computerId, m_computerGroupsFilter ),
+											  m_defaultSearchScope );
+	} );
 }
 
 
 
 QString LdapDirectory::userLoginName( const QString& userDn )
 {
-	return m_client.queryAttributeValues( userDn, m_userLoginNameAttribute ).value( 0 );
+	return cachedQuery( CacheQueryType::UserLoginName, userDn, [=]() {
+		return m_client.queryAttributeValues( userDn, m_userLoginNameAttribute ).mid( 0, 1 );
+	} ).value( 0 );
 }
 
 
@@ -414,6 +439,189 @@ QStringList LdapDirectory::computerLocationEntries( const QString& locationName
 
 
 
+/*!
+ * \brief Starts the LDAP search required for resolving the locations of all computers
+ * \param modifiedSince Optional timestamp for only querying computers or groups modified since then
+ * \return ID of the query to be passed to computerLocationsEntries()
+ *
+ * The search runs while further queries (e.g. for computer objects) are issued. Location
+ * containers are always queried completely as they're required for assigning any computer.
+ */
+int LdapDirectory::beginComputerLocationsQuery( const QString& modifiedSince )
+{
+	if( m_computerLocationsByAttribute )
+	{
+		return m_client.beginQueryObjects( computersDn(), { m_computerLocationAttribute },
+										   modifiedSinceFilter( modifiedSince,
+																LdapClient::constructQueryFilter( m_computerLocationAttribute, {}, m_computersFilter ) ),
+										   m_defaultSearchScope );
+	}
+	else if( m_computerLocationsByContainer )
+	{
+		return m_client.beginQueryObjects( computersDn(), { m_locationNameAttribute },
+										   LdapClient::constructQueryFilter( m_locationNameAttribute, {}, m_computerContainersFilter ),
+										   m_defaultSearchScope );
+	}
+
+	QStringList groupAttributes{ m_locationNameAttribute };
+	if( m_groupMemberAttribute.isEmpty() == false )
+	{
+		groupAttributes.append( m_groupMemberAttribute );
+	}
+
+	return m_client.beginQueryObjects( computerGroupsDn(), groupAttributes,
+									   modifiedSinceFilter( modifiedSince,
+															LdapClient::constructQueryFilter( m_locationNameAttribute, {}, m_computerGroupsFilter ) ),
+									   m_defaultSearchScope );
+}
+
+
+
+/*!
+ * \brief Returns the DNs of the given computer objects grouped by location name
+ * \param locationsQueryId ID of the query returned by beginComputerLocationsQuery()
+ * \param computers Computer objects as returned by computerObjects() - computers not included are ignored
+ * \return Map of location names to DNs of computers, including locations without computers
+ *
+ * In contrast to calling computerLocationEntries() for each location this function resolves
+ * the locations of all computers with a single LDAP search.
+ */
+QMap<QString, QStringList> LdapDirectory::computerLocationsEntries( int locationsQueryId,
+																	const LdapClient::Objects& computers )
+{
+	QMap<QString, QStringList> locationEntries;
+
+	if( m_computerLocationsByAttribute )
+	{
+		const auto computerLocations = m_client.endQueryObjects( locationsQueryId );
+
+		for( auto it = computerLocations.constBegin(), end = computerLocations.constEnd(); it != end; ++it )
+		{
+			if( computers.contains( it.key() ) && it.value().isEmpty() == false )
+			{
+				const auto locations = it.value().first();
+				for( const auto& location : locations )
+				{
+					locationEntries[location].append( it.key() );
+				}
+			}
+		}
+	}
+	else if( m_computerLocationsByContainer )
+	{
+		const auto containers = m_client.endQueryObjects( locationsQueryId );
+
+		QHash<QString, QString> containerLocations;
+		containerLocations.reserve( containers.size() );
+
+		for( auto it = containers.constBegin(), end = containers.constEnd(); it != end; ++it )
+		{
+			const auto location = it.value().isEmpty() ? QString() : it.value().first().value( 0 );
+			if( location.isEmpty() == false && locationEntries.contains( location ) == false )
+			{
+				containerLocations[LdapClient::toRDNs( it.key() ).join( QLatin1Char(',') ).toLower()] = location;
+				locationEntries[location] = {};
+			}
+		}
+
+		// computers may reside in sub containers of a location container
+		for( auto it = computers.constBegin(), end = computers.constEnd(); it != end; ++it )
+		{
+			for( auto containerDn = LdapClient::parentDn( it.key() ).toLower(); containerDn.isEmpty() == false;
+				 containerDn = LdapClient::parentDn( containerDn ) )
+			{
+				const auto location = containerLocations.constFind( containerDn );
+				if( location != containerLocations.constEnd() )
+				{
+					locationEntries[*location].append( it.key() );
+					break;
+				}
+			}
+		}
+	}
+	else
+	{
+		// DNs and host names are case insensitive and DNs may differ in formatting
+		const auto memberKey = [this]( const QString& member ) {
+			return m_identifyGroupMembersByNameAttribute ? member.toLower() :
+														   LdapClient::toRDNs( member ).join( QLatin1Char(',') ).toLower();
+		};
+
+		QHash<QString, QString> computerMembers;
+		computerMembers.reserve( computers.size() );
+
+		for( auto it = computers.constBegin(), end = computers.constEnd(); it != end; ++it )
+		{
+			if( m_identifyGroupMembersByNameAttribute )
+			{
+				computerMembers[memberKey( it.value().value( m_computerHostNameAttribute ).value( 0 ) )] = it.key();
+			}
+			else
+			{
+				computerMembers[memberKey( it.key() )] = it.key();
+			}
+		}
+
+		const auto groups = m_client.endQueryObjects( locationsQueryId );
+
+		for( const auto& group : groups )
+		{
+			const auto location = group.value( m_locationNameAttribute ).value( 0 );
+			if( location.isEmpty() || locationEntries.contains( location ) )
+			{
+				continue;
+			}
+
+			auto& entries = locationEntries[location];
+
+			const auto members = group.value( m_groupMemberAttribute );
+			for( const auto& member : members )
+			{
+				const auto computer = computerMembers.constFind( memberKey( member ) );
+				if( computer != computerMembers.constEnd() && computer->isEmpty() == false )
+				{
+					entries.append( *computer );
+				}
+			}
+		}
+	}
+
+	return locationEntries;
+}
+
+
+
+/*!
+ * \brief Returns all matching computer objects including the requested attributes
+ * \param attributes List of attributes to fetch for each computer object
+ * \param filterAttribute An optional attribute to filter computer objects by
+ * \param filterValue A filter value for the given filter attribute
+ * \return Map of DNs of all matching computer objects to their attributes
+ */
+LdapClient::Objects LdapDirectory::computerObjects( const QStringList& attributes,
+													const QString& filterAttribute, const QString& filterValue )
+{
+	return m_client.queryObjects( computersDn(), attributes,
+								  LdapClient::constructQueryFilter( filterAttribute, filterValue, m_computersFilter ),
+								  computerSearchScope() );
+}
+
+
+
+/*!
+ * \brief Returns all computer objects which have been modified since the given timestamp
+ * \param attributes List of attributes to fetch for each computer object
+ * \param modifiedSince Timestamp in LDAP generalized time format as returned for modifyTimestampAttribute()
+ */
+LdapClient::Objects LdapDirectory::modifiedComputerObjects( const QStringList& attributes, const QString& modifiedSince )
+{
+	return m_client.queryObjects( computersDn(), attributes,
+								  modifiedSinceFilter( modifiedSince, LdapClient::constructQueryFilter( {}, {}, m_computersFilter ) ),
+								  computerSearchScope() );
+}
+
+
+
 QString LdapDirectory::hostToLdapFormat( const QString& host )
 {
 	if( m_computerHostNameAsFQDN )
@@ -428,22 +636,152 @@ QString LdapDirectory::hostToLdapFormat( const QString& host )
 
 QString LdapDirectory::computerObjectFromHost( const QString& host )
 {
-	const auto hostName = hostToLdapFormat( host );
-	if( hostName.isEmpty() )
-	{
-		vWarning() << "could not resolve hostname, returning empty computer object";
+	return cachedQuery( CacheQueryType::ComputerObjectFromHost, host, [=]() -> QStringList {
+		const auto hostName = hostToLdapFormat( host );
+		if( hostName.isEmpty() )
+		{
+			vWarning() << "could not resolve hostname, returning empty computer object";
+			return {};
+		}
+
+		const auto computerObjects = computersByHostName( hostName );
+		if( computerObjects.count() == 1 )
+		{
+			return computerObjects;
+		}
+
+		// return empty result if not exactly one object was found
+		vWarning() << "more than one computer object found, returning empty computer object!";
 		return {};
+	} ).value( 0 );
+}
+
+
+
+/*!
+ * \brief Returns hit and miss counters of the lookup cache for the given query type
+ */
+LdapDirectory::CacheStatistics LdapDirectory::cacheStatistics( CacheQueryType type ) const
+{
+	return m_cacheStatistics.value( static_cast<int>( type ) );
+}
+
+
+
+/*!
+ * \brief Removes all cached lookup results, e.g. after objects have been modified in the directory
+ */
+void LdapDirectory::invalidateCache()
+{
+	m_cache.clear();
+}
+
+
+
+QStringList LdapDirectory::cachedQuery( CacheQueryType type, const QString& key, const std::function<QStringList()>& query )
+{
+	logCacheStatistics();
+
+	auto& statistics = m_cacheStatistics[static_cast<int>( type )];
+
+	const CacheKey cacheKey( static_cast<int>( type ), key );
+
+	const auto entry = m_cache.object( cacheKey );
+	if( entry && m_cacheTimer.elapsed() < entry->expiry )
+	{
+		if( entry->values.isEmpty() )
+		{
+			++statistics.negativeHits;
+		}
+		else
+		{
+			++statistics.hits;
+		}
+
+		return entry->values;
+	}
+
+	++statistics.misses;
+
+	const auto failedQueryCount = m_client.failedQueryCount();
+
+	const auto values = query();
+
+	// do not cache results of failed queries as they do not reflect the directory's contents
+	if( m_client.failedQueryCount() != failedQueryCount )
+	{
+		m_cache.remove( cacheKey );
+		return values;
+	}
+
+	// cache empty results (e.g. unknown users or hosts) for a shorter time only
+	const auto timeToLive = values.isEmpty() ? NegativeCacheTimeToLive : cacheTimeToLive( type );
+
+	m_cache.insert( cacheKey, new CacheEntry{ values, m_cacheTimer.elapsed() + timeToLive } );
+
+	return values;
+}
+
+
+
+void LdapDirectory::logCacheStatistics()
+{
+	if( m_cacheTimer.elapsed() < m_nextCacheStatisticsLogTime )
+	{
+		return;
+	}
+
+	m_nextCacheStatisticsLogTime = m_cacheTimer.elapsed() + CacheStatisticsLogInterval;
+
+	for( int i = 0; i < m_cacheStatistics.size(); ++i )
+	{
+		const auto& statistics = m_cacheStatistics[i];
+		vDebug() << "cache statistics for" << static_cast<CacheQueryType>( i )
+				 << "- hits:" << statistics.hits
+				 << "negative hits:" << statistics.negativeHits
+				 << "misses:" << statistics.misses;
+	}
+}
+
+
+
+int LdapDirectory::cacheTimeToLive( CacheQueryType type )
+{
+	switch( type )
+	{
+	case CacheQueryType::Users:
+	case CacheQueryType::UserLoginName:
+		return UserCacheTimeToLive;
+	case CacheQueryType::GroupsOfUser:
+		return GroupsOfUserCacheTimeToLive;
+	case CacheQueryType::GroupsOfComputer:
+	case CacheQueryType::LocationsOfComputer:
+	case CacheQueryType::ComputerObjectFromHost:
+		return ComputerCacheTimeToLive;
+	default:
+		break;
+	}
+
+	return NegativeCacheTimeToLive;
+}
+
+
+
+QString LdapDirectory::modifiedSinceFilter( const QString& modifiedSince, const QString& filter )
+{
+	if( modifiedSince.isEmpty() )
+	{
+		return filter;
 	}
 
-	const auto computerObjects = computersByHostName( hostName );
-	if( computerObjects.count() == 1 )
+	const auto timestampFilter = QStringLiteral( "(%1>=%2)" ).arg( modifyTimestampAttribute(),
+																  LdapClient::escapeFilterValue( modifiedSince ) );
+	if( filter.isEmpty() )
 	{
-		return computerObjects.first();
+		return timestampFilter;
 	}
 
-	// return empty result if not exactly one object was found
-	vWarning() << "more than one computer object found, returning empty computer object!";
-	return {};
+	return QStringLiteral( "(&%1%2)" ).arg( filter, timestampFilter );
 }
 
 
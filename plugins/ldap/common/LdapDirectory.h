@@ -24,6 +24,11 @@
 
 #pragma once
 
+#include <QCache>
+#include <QElapsedTimer>
+
+#include <functional>
+
 #include "LdapClient.h"
 #include "LdapCommon.h"
 #include "VeyonCore.h"
@@ -35,6 +40,24 @@ class LDAP_COMMON_EXPORT LdapDirectory : public QObject
 {
 	Q_OBJECT
 public:
+	enum class CacheQueryType {
+		Users,
+		GroupsOfUser,
+		GroupsOfComputer,
+		LocationsOfComputer,
+		ComputerObjectFromHost,
+		UserLoginName,
+		Count
+	};
+	Q_ENUM(CacheQueryType)
+
+	struct CacheStatistics
+	{
+		quint64 hits{0};
+		quint64 negativeHits{0};
+		quint64 misses{0};
+	};
+
 	explicit LdapDirectory( const LdapConfiguration& configuration, QObject* parent = nullptr );
 	~LdapDirectory() override = default;
 
@@ -79,6 +102,17 @@ public:
 	QString groupMemberComputerIdentification( const QString& computerDn );
 
 	QStringList computerLocationEntries( const QString& locationName );
+	int beginComputerLocationsQuery( const QString& modifiedSince = {} );
+	QMap<QString, QStringList> computerLocationsEntries( int locationsQueryId, const LdapClient::Objects& computers );
+
+	LdapClient::Objects computerObjects( const QStringList& attributes,
+										 const QString& filterAttribute = {}, const QString& filterValue = {} );
+	LdapClient::Objects modifiedComputerObjects( const QStringList& attributes, const QString& modifiedSince );
+
+	static QString modifyTimestampAttribute()
+	{
+		return QStringLiteral("modifyTimestamp");
+	}
 
 	QString hostToLdapFormat( const QString& host );
 	QString computerObjectFromHost( const QString& host );
@@ -118,9 +152,35 @@ public:
 		return m_computerLocationsByContainer;
 	}
 
+	CacheStatistics cacheStatistics( CacheQueryType type ) const;
+
+	void invalidateCache();
+
 private:
+	static constexpr int CacheSize = 4096;
+	static constexpr int UserCacheTimeToLive = 10*60*1000;
+	static constexpr int GroupsOfUserCacheTimeToLive = 60*1000;
+	static constexpr int ComputerCacheTimeToLive = 5*60*1000;
+	static constexpr int NegativeCacheTimeToLive = 30*1000;
+	static constexpr int CacheStatisticsLogInterval = 10*60*1000;
+
+	// query type and key (e.g. user or computer DN)
+	using CacheKey = QPair<int, QString>;
+
+	struct CacheEntry
+	{
+		QStringList values;
+		qint64 expiry;
+	};
+
+	QStringList cachedQuery( CacheQueryType type, const QString& key, const std::function<QStringList()>& query );
+	static int cacheTimeToLive( CacheQueryType type );
+	void logCacheStatistics();
+
 	LdapClient::Scope computerSearchScope() const;
 
+	static QString modifiedSinceFilter( const QString& modifiedSince, const QString& filter );
+
 	const LdapConfiguration& m_configuration;
 	LdapClient m_client;
 
@@ -151,4 +211,9 @@ private:
 	bool m_computerLocationsByAttribute = false;
 	bool m_computerHostNameAsFQDN = false;
 
+	QCache<CacheKey, CacheEntry> m_cache;
+	QVector<CacheStatistics> m_cacheStatistics;
+	QElapsedTimer m_cacheTimer;
+	qint64 m_nextCacheStatisticsLogTime = CacheStatisticsLogInterval;
+
 };
@@ -30,12 +30,34 @@
 LdapNetworkObjectDirectory::LdapNetworkObjectDirectory( const LdapConfiguration& ldapConfiguration,
 														QObject* parent ) :
 	NetworkObjectDirectory( parent ),
-	m_ldapDirectory( ldapConfiguration )
+	m_ldapConfiguration( ldapConfiguration ),
+	m_ldapDirectory( ldapConfiguration ),
+	m_syncState( QSharedPointer<SyncState>::create() )
 {
 }
 
 
 
+LdapNetworkObjectDirectory::~LdapNetworkObjectDirectory()
+{
+	// clone() accesses our members from the background update thread
+	waitForBackgroundUpdate();
+}
+
+
+
+NetworkObjectDirectory* LdapNetworkObjectDirectory::clone() const
+{
+	auto directory = new LdapNetworkObjectDirectory( m_ldapConfiguration, nullptr );
+
+	// continue incremental updates in cloned instance
+	directory->m_syncState = m_syncState;
+
+	return directory;
+}
+
+
+
 NetworkObjectList LdapNetworkObjectDirectory::queryObjects( NetworkObject::Type type,
 															NetworkObject::Attribute attribute, const QVariant& value )
 {
@@ -69,41 +91,201 @@ NetworkObjectList LdapNetworkObjectDirectory::queryParents( const NetworkObject&
 
 
 
+QStringList LdapNetworkObjectDirectory::locationsOfHost( const QString& hostAddress )
+{
+	// use the cached lookups of LdapDirectory instead of loading all objects from the directory
+	const auto computerDn = m_ldapDirectory.computerObjectFromHost( hostAddress );
+	if( computerDn.isEmpty() )
+	{
+		return {};
+	}
+
+	auto locations = m_ldapDirectory.locationsOfComputer( computerDn );
+	std::sort( locations.begin(), locations.end() );
+
+	return locations;
+}
+
+
+
 void LdapNetworkObjectDirectory::update()
 {
-	const auto locations = m_ldapDirectory.computerLocations();
+	if( m_ldapConfiguration.incrementalDirectoryUpdates() == false )
+	{
+		// fetch all computers including their attributes and their locations at once instead of
+		// querying each location and computer individually - both searches run simultaneously
+		const auto locationsQuery = m_ldapDirectory.beginComputerLocationsQuery();
+		const auto computers = m_ldapDirectory.computerObjects( computerAttributes( &m_ldapDirectory ) );
+
+		updateObjects( m_ldapDirectory.computerLocationsEntries( locationsQuery, computers ), computers );
+		return;
+	}
+
+	// instances sharing the synchronization state may be updated in different threads
+	QMutexLocker locker( &m_syncState->mutex );
+
+	if( m_syncState->highWaterMark.isEmpty() || m_syncState->incrementalUpdates >= FullUpdateInterval )
+	{
+		performFullSync( *m_syncState );
+	}
+	else
+	{
+		performIncrementalSync( *m_syncState );
+	}
+}
+
+
+
+void LdapNetworkObjectDirectory::performFullSync( SyncState& state )
+{
+	auto attributes = computerAttributes( &m_ldapDirectory );
+	attributes.append( LdapDirectory::modifyTimestampAttribute() );
+
+	const auto locationsQuery = m_ldapDirectory.beginComputerLocationsQuery();
+
+	state.computers = m_ldapDirectory.computerObjects( attributes );
+	state.locationEntries = m_ldapDirectory.computerLocationsEntries( locationsQuery, state.computers );
+	state.highWaterMark = highWaterMark( state.computers );
+	state.incrementalUpdates = 0;
+
+	updateObjects( state.locationEntries, state.computers );
+}
+
+
+
+void LdapNetworkObjectDirectory::performIncrementalSync( SyncState& state )
+{
+	auto attributes = computerAttributes( &m_ldapDirectory );
+	attributes.append( LdapDirectory::modifyTimestampAttribute() );
+
+	// only query objects which have been modified since the last update
+	const auto locationsQuery = m_ldapDirectory.beginComputerLocationsQuery( state.highWaterMark );
+	const auto modifiedComputers = m_ldapDirectory.modifiedComputerObjects( attributes, state.highWaterMark );
+
+	QSet<QString> modifiedComputerDns;
+	modifiedComputerDns.reserve( modifiedComputers.size() );
+
+	for( auto it = modifiedComputers.constBegin(), end = modifiedComputers.constEnd(); it != end; ++it )
+	{
+		state.computers[it.key()] = it.value();
+		modifiedComputerDns.insert( it.key() );
+	}
+
+	const auto modifiedLocationEntries = m_ldapDirectory.computerLocationsEntries( locationsQuery, state.computers );
+
+	if( m_ldapDirectory.computerLocationsByAttribute() )
+	{
+		// locations have been queried for modified computers only so reassign these
+		for( auto it = state.locationEntries.begin(); it != state.locationEntries.end(); )
+		{
+			auto& entries = it.value();
+			entries.erase( std::remove_if( entries.begin(), entries.end(),
+										   [&modifiedComputerDns]( const QString& dn ) { return modifiedComputerDns.contains( dn ); } ),
+						   entries.end() );
+
+			if( entries.isEmpty() )
+			{
+				it = state.locationEntries.erase( it );
+			}
+			else
+			{
+				++it;
+			}
+		}
+
+		for( auto it = modifiedLocationEntries.constBegin(), end = modifiedLocationEntries.constEnd(); it != end; ++it )
+		{
+			state.locationEntries[it.key()].append( it.value() );
+		}
+	}
+	else if( m_ldapDirectory.computerLocationsByContainer() )
+	{
+		// all location containers have been queried so computers have been assigned completely
+		state.locationEntries = modifiedLocationEntries;
+	}
+	else
+	{
+		// only modified groups have been queried along with all of their members
+		for( auto it = modifiedLocationEntries.constBegin(), end = modifiedLocationEntries.constEnd(); it != end; ++it )
+		{
+			state.locationEntries[it.key()] = it.value();
+		}
+	}
+
+	state.highWaterMark = qMax( state.highWaterMark, highWaterMark( modifiedComputers ) );
+	++state.incrementalUpdates;
+
+	updateObjects( state.locationEntries, state.computers );
+}
+
+
+
+void LdapNetworkObjectDirectory::updateObjects( const QMap<QString, QStringList>& locationEntries,
+												const LdapClient::Objects& computers )
+{
 	const NetworkObject rootObject( NetworkObject::Type::Root );
 
-	for( const auto& location : qAsConst( locations ) )
+	QSet<QString> locations;
+	locations.reserve( locationEntries.size() );
+
+	for( auto it = locationEntries.constBegin(), end = locationEntries.constEnd(); it != end; ++it )
 	{
-		const NetworkObject locationObject( NetworkObject::Type::Location, location );
+		const NetworkObject locationObject( NetworkObject::Type::Location, it.key() );
 
 		addOrUpdateObject( locationObject, rootObject );
 
-		updateLocation( locationObject );
+		updateLocation( locationObject, it.value(), computers );
+
+		locations.insert( it.key() );
 	}
 
-	removeObjects( NetworkObject( NetworkObject::Type::Root ), [locations]( const NetworkObject& object ) {
+	removeObjects( rootObject, [&locations]( const NetworkObject& object ) {
 		return object.type() == NetworkObject::Type::Location && locations.contains( object.name() ) == false; } );
 }
 
 
 
-void LdapNetworkObjectDirectory::updateLocation( const NetworkObject& locationObject )
+void LdapNetworkObjectDirectory::updateLocation( const NetworkObject& locationObject, const QStringList& computerDns,
+												 const LdapClient::Objects& computers )
 {
-	const auto computers = m_ldapDirectory.computerLocationEntries( locationObject.name() );
+	QSet<QString> locationComputers;
+	locationComputers.reserve( computerDns.size() );
 
-	for( const auto& computer : qAsConst( computers ) )
+	for( const auto& computerDn : computerDns )
 	{
-		const auto hostObject = computerToObject( &m_ldapDirectory, computer );
+		const auto hostObject = computerToObject( &m_ldapDirectory, computerDn, computers.value( computerDn ) );
 		if( hostObject.type() == NetworkObject::Type::Host )
 		{
 			addOrUpdateObject( hostObject, locationObject );
+			locationComputers.insert( computerDn );
+		}
+	}
+
+	removeObjects( locationObject, [&locationComputers]( const NetworkObject& object ) {
+		return object.type() == NetworkObject::Type::Host && locationComputers.contains( object.directoryAddress() ) == false; } );
+}
+
+
+
+QString LdapNetworkObjectDirectory::highWaterMark( const LdapClient::Objects& computers )
+{
+	QString highWaterMark;
+
+	for( const auto& computer : computers )
+	{
+		for( auto it = computer.constBegin(), end = computer.constEnd(); it != end; ++it )
+		{
+			// attribute name may be returned with different case (e.g. modifyTimeStamp by AD)
+			if( it.key().compare( LdapDirectory::modifyTimestampAttribute(), Qt::CaseInsensitive ) == 0 )
+			{
+				// generalized time values of the same server can be compared lexically
+				highWaterMark = qMax( highWaterMark, it.value().value( 0 ) );
+				break;
+			}
 		}
 	}
 
-	removeObjects( locationObject, [computers]( const NetworkObject& object ) {
-		return object.type() == NetworkObject::Type::Host && computers.contains( object.directoryAddress() ) == false; } );
+	return highWaterMark;
 }
 
 
@@ -143,20 +325,23 @@ NetworkObjectList LdapNetworkObjectDirectory::queryLocations( NetworkObject::Att
 
 NetworkObjectList LdapNetworkObjectDirectory::queryHosts( NetworkObject::Attribute attribute, const QVariant& value )
 {
-	QStringList computers;
+	const auto attributes = computerAttributes( &m_ldapDirectory );
+	LdapClient::Objects computers;
 
 	switch( attribute )
 	{
 	case NetworkObject::Attribute::None:
-		computers = m_ldapDirectory.computersByHostName( {} );
+		computers = m_ldapDirectory.computerObjects( attributes, m_ldapDirectory.computerHostNameAttribute() );
 		break;
 
 	case NetworkObject::Attribute::Name:
-		computers = m_ldapDirectory.computersByDisplayName( value.toString() );
+		computers = m_ldapDirectory.computerObjects( attributes, m_ldapDirectory.computerDisplayNameAttribute(),
+													 value.toString() );
 		break;
 
 	case NetworkObject::Attribute::HostAddress:
-		computers = m_ldapDirectory.computersByHostName( m_ldapDirectory.hostToLdapFormat( value.toString() ) );
+		computers = m_ldapDirectory.computerObjects( attributes, m_ldapDirectory.computerHostNameAttribute(),
+													 m_ldapDirectory.hostToLdapFormat( value.toString() ) );
 		break;
 	default:
 		vCritical() << "Can't query hosts by attribute" << attribute;
@@ -166,9 +351,9 @@ NetworkObjectList LdapNetworkObjectDirectory::queryHosts( NetworkObject::Attribu
 	NetworkObjectList hostObjects;
 	hostObjects.reserve( computers.size() );
 
-	for( const auto& computer : computers )
+	for( auto it = computers.constBegin(), end = computers.constEnd(); it != end; ++it )
 	{
-		const auto hostObject = computerToObject( &m_ldapDirectory, computer );
+		const auto hostObject = computerToObject( &m_ldapDirectory, it.key(), it.value() );
 		if( hostObject.isValid() )
 		{
 			hostObjects.append( hostObject );
@@ -181,6 +366,51 @@ NetworkObjectList LdapNetworkObjectDirectory::queryHosts( NetworkObject::Attribu
 
 
 NetworkObject LdapNetworkObjectDirectory::computerToObject( LdapDirectory* directory, const QString& computerDn )
+{
+	const auto computers = directory->client().queryObjects( computerDn, computerAttributes( directory ),
+															 directory->computersFilter(), LdapClient::Scope::Base );
+	if( computers.isEmpty() == false )
+	{
+		return computerToObject( directory, computers.firstKey(), computers.first() );
+	}
+
+	return NetworkObject( NetworkObject::Type::None );
+}
+
+
+
+NetworkObject LdapNetworkObjectDirectory::computerToObject( LdapDirectory* directory, const QString& computerDn,
+															const QMap<QString, QStringList>& attributes )
+{
+	if( attributes.isEmpty() )
+	{
+		return NetworkObject( NetworkObject::Type::None );
+	}
+
+	auto displayNameAttribute = directory->computerDisplayNameAttribute();
+	if( displayNameAttribute.isEmpty() )
+	{
+		displayNameAttribute = QStringLiteral("cn");
+	}
+
+	auto hostNameAttribute = directory->computerHostNameAttribute();
+	if( hostNameAttribute.isEmpty() )
+	{
+		hostNameAttribute = QStringLiteral("cn");
+	}
+
+	const auto macAddressAttribute = directory->computerMacAddressAttribute();
+
+	const auto displayName = attributes.value( displayNameAttribute ).value( 0 );
+	const auto hostName = attributes.value( hostNameAttribute ).value( 0 );
+	const auto macAddress = ( macAddressAttribute.isEmpty() == false ) ? attributes.value( macAddressAttribute ).value( 0 ) : QString();
+
+	return NetworkObject( NetworkObject::Type::Host, displayName, hostName, macAddress, computerDn );
+}
+
+
+
+QStringList LdapNetworkObjectDirectory::computerAttributes( LdapDirectory* directory )
 {
 	auto displayNameAttribute = directory->computerDisplayNameAttribute();
 	if( displayNameAttribute.isEmpty() )
@@ -196,7 +426,7 @@ NetworkObject LdapNetworkObjectDirectory::computerToObject( LdapDirectory* direc
 
 	QStringList computerAttributes{ displayNameAttribute, hostNameAttribute };
 
-	auto macAddressAttribute = directory->computerMacAddressAttribute();
+	const auto macAddressAttribute = directory->computerMacAddressAttribute();
 	if( macAddressAttribute.isEmpty() == false )
 	{
 		computerAttributes.append( macAddressAttribute );
@@ -204,18 +434,5 @@ NetworkObject LdapNetworkObjectDirectory::computerToObject( LdapDirectory* direc
 
 	computerAttributes.removeDuplicates();
 
-	const auto computers = directory->client().queryObjects( computerDn, computerAttributes,
-															 directory->computersFilter(), LdapClient::Scope::Base );
-	if( computers.isEmpty() == false )
-	{
-		const auto& computerDn = computers.firstKey();
-		const auto& computer = computers.first();
-		const auto displayName = computer[displayNameAttribute].value( 0 );
-		const auto hostName = computer[hostNameAttribute].value( 0 );
-		const auto macAddress = ( macAddressAttribute.isEmpty() == false ) ? computer[macAddressAttribute].value( 0 ) : QString();
-
-		return NetworkObject( NetworkObject::Type::Host, displayName, hostName, macAddress, computerDn );
-	}
-
-	return NetworkObject( NetworkObject::Type::None );
+	return computerAttributes;
 }
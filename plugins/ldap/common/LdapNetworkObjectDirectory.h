@@ -24,6 +24,9 @@
 
 #pragma once
 
+#include <QMutex>
+#include <QSharedPointer>
+
 #include "LdapDirectory.h"
 #include "NetworkObjectDirectory.h"
 
@@ -32,19 +35,48 @@ class LDAP_COMMON_EXPORT LdapNetworkObjectDirectory : public NetworkObjectDirect
 	Q_OBJECT
 public:
 	LdapNetworkObjectDirectory( const LdapConfiguration& ldapConfiguration, QObject* parent );
+	~LdapNetworkObjectDirectory() override;
 
 	NetworkObjectList queryObjects( NetworkObject::Type type,
 									NetworkObject::Attribute attribute, const QVariant& value ) override;
 	NetworkObjectList queryParents( const NetworkObject& childId ) override;
+	QStringList locationsOfHost( const QString& hostAddress ) override;
 
 	static NetworkObject computerToObject( LdapDirectory* directory, const QString& computerDn );
+	static NetworkObject computerToObject( LdapDirectory* directory, const QString& computerDn,
+										   const QMap<QString, QStringList>& attributes );
+
+protected:
+	NetworkObjectDirectory* clone() const override;
 
 private:
+	// number of incremental updates after which a full update is performed to detect removed objects
+	static constexpr int FullUpdateInterval = 10;
+
+	struct SyncState
+	{
+		QMutex mutex;
+		QString highWaterMark;
+		int incrementalUpdates{0};
+		LdapClient::Objects computers;
+		QMap<QString, QStringList> locationEntries;
+	};
+
 	void update() override;
-	void updateLocation( const NetworkObject& locationObject );
+	void performFullSync( SyncState& state );
+	void performIncrementalSync( SyncState& state );
+	void updateObjects( const QMap<QString, QStringList>& locationEntries, const LdapClient::Objects& computers );
+	void updateLocation( const NetworkObject& locationObject, const QStringList& computerDns,
+						 const LdapClient::Objects& computers );
+
+	static QString highWaterMark( const LdapClient::Objects& computers );
+
+	static QStringList computerAttributes( LdapDirectory* directory );
 
 	NetworkObjectList queryLocations( NetworkObject::Attribute attribute, const QVariant& value );
 	NetworkObjectList queryHosts( NetworkObject::Attribute attribute, const QVariant& value );
 
+	const LdapConfiguration& m_ldapConfiguration;
 	LdapDirectory m_ldapDirectory;
+	QSharedPointer<SyncState> m_syncState;
 };
@@ -24,6 +24,7 @@
 
 #include <QDataStream>
 #include <QDBusReply>
+#include <QFileInfo>
 #include <QProcess>
 
 #include "LinuxCoreFunctions.h"
@@ -37,17 +38,20 @@
 
 #include <X11/keysymdef.h>
 
+#include <cerrno>
+#include <grp.h>
 #include <pwd.h>
 #include <unistd.h>
 
 
 QString LinuxUserFunctions::fullName( const QString& username )
 {
-	auto pw_entry = getpwnam( VeyonCore::stripDomain( username ).toUtf8().constData() );
+	QByteArray buffer;
+	struct passwd userEntry{};
 
-	if( pw_entry )
+	if( queryUserEntry( VeyonCore::stripDomain( username ).toUtf8(), userEntry, buffer ) )
 	{
-		auto shell = QString::fromUtf8( pw_entry->pw_shell );
+		auto shell = QString::fromUtf8( userEntry.pw_shell );
 
 		// Skip not real users
 		if ( !( shell.endsWith( QStringLiteral( "/false" ) ) ||
@@ -55,7 +59,7 @@ QString LinuxUserFunctions::fullName( const QString& username )
 				shell.endsWith( QStringLiteral( "/null" ) ) ||
 				shell.endsWith( QStringLiteral( "/nologin" ) ) ) )
 		{
-			return QString::fromUtf8( pw_entry->pw_gecos ).split( QLatin1Char(',') ).first();
+			return QString::fromUtf8( userEntry.pw_gecos ).split( QLatin1Char(',') ).first();
 		}
 	}
 
@@ -68,21 +72,17 @@ QStringList LinuxUserFunctions::userGroups( bool queryDomainGroups )
 {
 	Q_UNUSED(queryDomainGroups)
 
-	QStringList groupList;
-
-	QProcess getentProcess;
-	getentProcess.start( QStringLiteral("getent"), { QStringLiteral("group") } );
-	getentProcess.waitForFinished();
+	QMutexLocker locker( &m_groupCacheMutex );
 
-	const auto groups = QString::fromUtf8( getentProcess.readAll() ).split( QLatin1Char('\n') );
+	validateGroupCache();
 
-	groupList.reserve( groups.size() );
-
-	for( const auto& group : groups )
+	if( m_userGroupsCache.isEmpty() == false )
 	{
-		groupList += group.split( QLatin1Char(':') ).first();
+		return m_userGroupsCache;
 	}
 
+	auto groupList = queryAllGroups();
+
 	const QStringList ignoredGroups( {
 		QStringLiteral("daemon"),
 		QStringLiteral("bin"),
@@ -165,6 +165,8 @@ QStringList LinuxUserFunctions::userGroups( bool queryDomainGroups )
 	// remove all empty entries
 	groupList.removeAll( QString() );
 
+	m_userGroupsCache = groupList;
+
 	return groupList;
 }
 
@@ -174,26 +176,21 @@ QStringList LinuxUserFunctions::groupsOfUser( const QString& username, bool quer
 {
 	Q_UNUSED(queryDomainGroups)
 
-	QStringList groupList;
-
 	const auto strippedUsername = VeyonCore::stripDomain( username );
 
-	QProcess getentProcess;
-	getentProcess.start( QStringLiteral("getent"), { QStringLiteral("group") } );
-	getentProcess.waitForFinished();
+	QMutexLocker locker( &m_groupCacheMutex );
+
+	validateGroupCache();
 
-	const auto groups = QString::fromUtf8( getentProcess.readAll() ).split( QLatin1Char('\n') );
-	for( const auto& group : groups )
+	const auto cachedGroups = m_groupsOfUserCache.constFind( strippedUsername );
+	if( cachedGroups != m_groupsOfUserCache.constEnd() )
 	{
-		const auto groupComponents = group.split( QLatin1Char(':') );
-		if( groupComponents.size() == 4 &&
-				groupComponents.last().split( QLatin1Char(',') ).contains( strippedUsername ) )
-		{
-			groupList += groupComponents.first(); // clazy:exclude=reserve-candidates
-		}
+		return *cachedGroups;
 	}
 
-	groupList.removeAll( QString() );
+	const auto groupList = queryGroupsOfUser( strippedUsername );
+
+	m_groupsOfUserCache[strippedUsername] = groupList;
 
 	return groupList;
 }
@@ -362,12 +359,163 @@ bool LinuxUserFunctions::authenticate( const QString& username, const Password&
 
 uid_t LinuxUserFunctions::userIdFromName( const QString& username )
 {
-	const auto pw_entry = getpwnam( username.toUtf8().constData() );
+	QByteArray buffer;
+	struct passwd userEntry{};
 
-	if( pw_entry )
+	if( queryUserEntry( username.toUtf8(), userEntry, buffer ) )
 	{
-		return pw_entry->pw_uid;
+		return userEntry.pw_uid;
 	}
 
 	return 0;
 }
+
+
+
+/*!
+ * \brief Drops cached group information if /etc/group has been modified or groups from other NSS sources
+ * (e.g. LDAP or Active Directory via SSSD/winbind) might be outdated
+ */
+void LinuxUserFunctions::validateGroupCache()
+{
+	const auto groupFileTimestamp = QFileInfo( QStringLiteral("/etc/group") ).lastModified();
+
+	if( m_groupCacheTimer.isValid() == false ||
+		m_groupCacheTimer.elapsed() > GroupCacheTimeToLive ||
+		groupFileTimestamp != m_groupFileTimestamp )
+	{
+		m_userGroupsCache.clear();
+		m_groupsOfUserCache.clear();
+		m_groupFileTimestamp = groupFileTimestamp;
+		m_groupCacheTimer.start();
+	}
+}
+
+
+
+QStringList LinuxUserFunctions::queryAllGroups()
+{
+	QStringList groupList;
+
+	QByteArray buffer( DefaultGroupBufferSize, 0 );
+	struct group groupEntry{};
+	struct group* result = nullptr;
+
+	setgrent();
+
+	forever
+	{
+		const auto error = getgrent_r( &groupEntry, buffer.data(), size_t( buffer.size() ), &result );
+		if( error == ERANGE )
+		{
+			// entry does not fit into buffer - retry with larger buffer
+			buffer.resize( buffer.size() * 2 );
+			continue;
+		}
+
+		if( error != 0 || result == nullptr )
+		{
+			break;
+		}
+
+		groupList.append( QString::fromUtf8( groupEntry.gr_name ) );
+	}
+
+	endgrent();
+
+	return groupList;
+}
+
+
+
+QStringList LinuxUserFunctions::queryGroupsOfUser( const QString& username )
+{
+	const auto name = username.toUtf8();
+
+	// use reentrant variant as groups are queried concurrently in the thread pool
+	QByteArray buffer;
+	struct passwd userEntry{};
+	if( queryUserEntry( name, userEntry, buffer ) == false )
+	{
+		return {};
+	}
+
+	const auto primaryGroupId = userEntry.pw_gid;
+
+	QVector<gid_t> groupIds( InitialGroupListSize );
+	int groupCount = groupIds.size();
+
+	while( getgrouplist( name.constData(), primaryGroupId, groupIds.data(), &groupCount ) < 0 )
+	{
+		// some implementations do not return the required size
+		groupIds.resize( qMax( groupCount, groupIds.size() * 2 ) );
+		groupCount = groupIds.size();
+	}
+
+	QStringList groupList;
+	groupList.reserve( groupCount );
+
+	for( int i = 0; i < groupCount; ++i )
+	{
+		// only report supplementary groups as primary groups are usually shared by all users
+		// (e.g. "users" or "domain users") and would make groups-in-common access control rules match anyone
+		if( groupIds[i] == primaryGroupId )
+		{
+			continue;
+		}
+
+		const auto group = groupName( groupIds[i] );
+		if( group.isEmpty() == false && groupList.contains( group ) == false )
+		{
+			groupList.append( group );
+		}
+	}
+
+	return groupList;
+}
+
+
+
+QString LinuxUserFunctions::groupName( gid_t groupId )
+{
+	const auto bufferSizeHint = sysconf( _SC_GETGR_R_SIZE_MAX );
+
+	QByteArray buffer( bufferSizeHint > 0 ? int( bufferSizeHint ) : DefaultGroupBufferSize, 0 );
+	struct group groupEntry{};
+	struct group* result = nullptr;
+
+	int error = 0;
+	while( ( error = getgrgid_r( groupId, &groupEntry, buffer.data(), size_t( buffer.size() ), &result ) ) == ERANGE )
+	{
+		buffer.resize( buffer.size() * 2 );
+	}
+
+	if( error != 0 || result == nullptr )
+	{
+		return {};
+	}
+
+	return QString::fromUtf8( groupEntry.gr_name );
+}
+
+
+
+/*!
+ * \brief Looks up the passwd entry of the given user in a thread-safe manner
+ * \param buffer storage for the strings referenced by \a userEntry
+ */
+bool LinuxUserFunctions::queryUserEntry( const QByteArray& name, struct passwd& userEntry, QByteArray& buffer )
+{
+	const auto bufferSizeHint = sysconf( _SC_GETPW_R_SIZE_MAX );
+
+	buffer.fill( 0, bufferSizeHint > 0 ? int( bufferSizeHint ) : DefaultUserBufferSize );
+	struct passwd* result = nullptr;
+
+	int error = 0;
+	while( ( error = getpwnam_r( name.constData(), &userEntry, buffer.data(), size_t( buffer.size() ), &result ) ) == ERANGE )
+	{
+		buffer.resize( buffer.size() * 2 );
+	}
+
+	return error == 0 && result != nullptr;
+}
@@ -24,9 +24,15 @@
 
 #pragma once
 
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+
 #include "LogonHelper.h"
 #include "PlatformUserFunctions.h"
 
+#include <grp.h>
 #include <pwd.h>
 
 // clazy:excludeall=copyable-polymorphic
@@ -53,7 +59,24 @@ public:
 private:
 	static constexpr auto WhoProcessTimeout = 3000;
 	static constexpr auto AuthHelperTimeout = 10000;
+	static constexpr auto GroupCacheTimeToLive = 60000;
+	static constexpr auto DefaultGroupBufferSize = 16384;
+	static constexpr auto DefaultUserBufferSize = 16384;
+	static constexpr auto InitialGroupListSize = 64;
+
+	void validateGroupCache();
+
+	static QStringList queryAllGroups();
+	static QStringList queryGroupsOfUser( const QString& username );
+	static QString groupName( gid_t groupId );
+	static bool queryUserEntry( const QByteArray& name, struct passwd& userEntry, QByteArray& buffer );
 
 	LogonHelper m_logonHelper{};
 
+	QMutex m_groupCacheMutex{};
+	QDateTime m_groupFileTimestamp{};
+	QElapsedTimer m_groupCacheTimer{};
+	QStringList m_userGroupsCache{};
+	QHash<QString, QStringList> m_groupsOfUserCache{};
+
 };
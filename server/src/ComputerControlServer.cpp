@@ -25,6 +25,7 @@
 #include <QCoreApplication>
 
 #include "AccessControlProvider.h"
+#include "AuthenticationManager.h"
 #include "BuiltinFeatures.h"
 #include "ComputerControlClient.h"
 #include "ComputerControlServer.h"
@@ -63,13 +64,22 @@ ComputerControlServer::ComputerControlServer( QObject* parent ) :
 
 	connect( &m_serverAccessControlManager, &ServerAccessControlManager::finished,
 			 this, &ComputerControlServer::showAccessControlMessage );
+
+	connect( &m_serverAccessControlManager, &ServerAccessControlManager::finished,
+			 &m_serverAuthenticationManager, &ServerAuthenticationManager::updateSessionTicket );
 }
 
 
 
 ComputerControlServer::~ComputerControlServer()
 {
-	vDebug();
+	const auto& connectionStatistics = m_vncProxyServer.connectionStatistics();
+	const auto& failureStatistics = m_serverAuthenticationManager.failureStatistics();
+
+	vDebug() << "accepted connections:" << connectionStatistics.accepted
+			 << "rate limited:" << connectionStatistics.rateLimited
+			 << "refused:" << connectionStatistics.refused
+			 << "failed authentications:" << failureStatistics.failedAuthentications;
 
 	m_vncProxyServer.stop();
 }
@@ -101,6 +111,13 @@ VncProxyConnection* ComputerControlServer::createVncProxyConnection( QTcpSocket*
 
 
 
+bool ComputerControlServer::isConnectionAllowed( const QHostAddress& peerAddress )
+{
+	return m_serverAuthenticationManager.admitConnection( peerAddress.toString() );
+}
+
+
+
 bool ComputerControlServer::handleFeatureMessage( QTcpSocket* socket )
 {
 	char messageType;
@@ -143,7 +160,9 @@ void ComputerControlServer::showAuthenticationMessage( VncServerClient* client )
 	{
 		vWarning() << "Authentication failed for" << client->hostAddress() << client->username();
 
-		if( VeyonCore::config().failedAuthenticationNotificationsEnabled() )
+		// outdated session tickets (e.g. after restarting the server) are no reason to notify the user
+		if( VeyonCore::config().failedAuthenticationNotificationsEnabled() &&
+			client->authPluginUid() != AuthenticationManager::sessionTicketUid() )
 		{
 			QMutexLocker l( &m_dataMutex );
 
@@ -151,13 +170,17 @@ void ComputerControlServer::showAuthenticationMessage( VncServerClient* client )
 			{
 				m_failedAuthHosts += client->hostAddress();
 
-				const auto fqdn = HostAddress( client->hostAddress() ).tryConvert( HostAddress::Type::FullyQualifiedDomainName );
-
-				VeyonCore::builtinFeatures().systemTrayIcon().showMessage(
-							tr( "Authentication error" ),
-							tr( "User \"%1\" at host \"%2\" attempted to access this computer "
-								"but could not authenticate successfully." ).arg( client->username(), fqdn ),
-							m_featureWorkerManager );
+				const auto username = client->username();
+
+				// resolve in background as a slow DNS server must not stall the server's event loop
+				HostAddress( client->hostAddress() ).tryConvertAsync( HostAddress::Type::FullyQualifiedDomainName, this,
+																	  [=]( const QString& fqdn ) {
+					VeyonCore::builtinFeatures().systemTrayIcon().showMessage(
+								tr( "Authentication error" ),
+								tr( "User \"%1\" at host \"%2\" attempted to access this computer "
+									"but could not authenticate successfully." ).arg( username, fqdn ),
+								m_featureWorkerManager );
+				} );
 			}
 		}
 	}
@@ -173,13 +196,16 @@ void ComputerControlServer::showAccessControlMessage( VncServerClient* client )
 
 		if( VeyonCore::config().remoteConnectionNotificationsEnabled() )
 		{
-			const auto fqdn = HostAddress( client->hostAddress() ).tryConvert( HostAddress::Type::FullyQualifiedDomainName );
+			const auto username = client->username();
 
-			VeyonCore::builtinFeatures().systemTrayIcon().showMessage(
-						tr( "Remote access" ),
-						tr( "User \"%1\" at host \"%2\" is now accessing this computer." ).
-						arg( client->username(), fqdn ),
-						m_featureWorkerManager );
+			HostAddress( client->hostAddress() ).tryConvertAsync( HostAddress::Type::FullyQualifiedDomainName, this,
+																  [=]( const QString& fqdn ) {
+				VeyonCore::builtinFeatures().systemTrayIcon().showMessage(
+							tr( "Remote access" ),
+							tr( "User \"%1\" at host \"%2\" is now accessing this computer." ).
+							arg( username, fqdn ),
+							m_featureWorkerManager );
+			} );
 		}
 	}
 	else if( client->accessControlState() == VncServerClient::AccessControlState::Failed )
@@ -194,14 +220,17 @@ void ComputerControlServer::showAccessControlMessage( VncServerClient* client )
 			{
 				m_failedAccessControlHosts += client->hostAddress();
 
-				const auto fqdn = HostAddress( client->hostAddress() ).tryConvert( HostAddress::Type::FullyQualifiedDomainName );
-
-				VeyonCore::builtinFeatures().systemTrayIcon().showMessage(
-							tr( "Access control error" ),
-							tr( "User \"%1\" at host \"%2\" attempted to access this computer "
-								"but has been blocked due to access control settings." ).
-							arg( client->username(), fqdn ),
-							m_featureWorkerManager );
+				const auto username = client->username();
+
+				HostAddress( client->hostAddress() ).tryConvertAsync( HostAddress::Type::FullyQualifiedDomainName, this,
+																	  [=]( const QString& fqdn ) {
+					VeyonCore::builtinFeatures().systemTrayIcon().showMessage(
+								tr( "Access control error" ),
+								tr( "User \"%1\" at host \"%2\" attempted to access this computer "
+									"but has been blocked due to access control settings." ).
+								arg( username, fqdn ),
+								m_featureWorkerManager );
+				} );
 			}
 		}
 	}
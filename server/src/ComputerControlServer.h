@@ -26,6 +26,7 @@
 
 #include <QtCore/QMutex>
 #include <QtCore/QStringList>
+#include <QtNetwork/QTcpSocket>
 
 #include "FeatureManager.h"
 #include "FeatureWorkerManager.h"
@@ -50,6 +51,8 @@ public:
 												  const Password& vncServerPassword,
 												  QObject* parent ) override;
 
+	bool isConnectionAllowed( const QHostAddress& peerAddress ) override;
+
 	ServerAuthenticationManager& authenticationManager()
 	{
 		return m_serverAuthenticationManager;
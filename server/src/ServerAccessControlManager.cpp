@@ -22,6 +22,8 @@
  *
  */
 
+#include <QtConcurrent>
+
 #include "ServerAccessControlManager.h"
 #include "AccessControlProvider.h"
 #include "AuthenticationManager.h"
@@ -35,9 +37,15 @@ ServerAccessControlManager::ServerAccessControlManager( FeatureWorkerManager& fe
 	QObject( parent ),
 	m_featureWorkerManager( featureWorkerManager ),
 	m_desktopAccessDialog( desktopAccessDialog ),
+	m_accessControlProvider(),
+	m_accessControlThreadPool(),
+	m_pendingAccessControls(),
 	m_clients(),
 	m_desktopAccessChoices()
 {
+	// access control backends (e.g. LDAP) are not reentrant, therefore evaluate
+	// requests one after another but outside the main thread
+	m_accessControlThreadPool.setMaxThreadCount( 1 );
 }
 
 
@@ -45,9 +53,20 @@ ServerAccessControlManager::ServerAccessControlManager( FeatureWorkerManager& fe
 void ServerAccessControlManager::addClient( VncServerClient* client )
 {
 	const auto plugins = VeyonCore::authenticationManager().plugins();
-	if( plugins.contains( client->authPluginUid() ) )
+	const auto resumedSession = client->authPluginUid() == AuthenticationManager::sessionTicketUid();
+
+	// sessions resumed via ticket have been authenticated with the configured plugin initially
+	const auto authPluginUid = resumedSession ? VeyonCore::config().authenticationPlugin() : client->authPluginUid();
+
+	// session tickets are only issued to clients which already passed access control - however
+	// connected clients have to pass access control again when re-checking them in removeClient()
+	if( resumedSession && m_clients.contains( client ) == false )
 	{
-		if( plugins[client->authPluginUid()]->requiresAccessControl() )
+		client->setAccessControlState( VncServerClient::AccessControlState::Successful );
+	}
+	else if( plugins.contains( authPluginUid ) )
+	{
+		if( plugins[authPluginUid]->requiresAccessControl() )
 		{
 			performAccessControl( client );
 		}
@@ -61,7 +80,8 @@ void ServerAccessControlManager::addClient( VncServerClient* client )
 		client->setAccessControlState( VncServerClient::AccessControlState::Failed );
 	}
 
-	if( client->accessControlState() == VncServerClient::AccessControlState::Successful )
+	if( client->accessControlState() == VncServerClient::AccessControlState::Successful &&
+		m_clients.contains( client ) == false )
 	{
 		m_clients.append( client );
 	}
@@ -74,22 +94,16 @@ void ServerAccessControlManager::removeClient( VncServerClient* client )
 	m_clients.removeAll( client );
 
 	// force all remaining clients to pass access control again as conditions might
-	// have changed (e.g. AccessControlRule::ConditionAccessFromAlreadyConnectedUser)
+	// have changed (e.g. AccessControlRule::ConditionAccessFromAlreadyConnectedUser) -
+	// clients which do not pass access control any longer are disconnected as soon
+	// as the asynchronous evaluation has finished
 
 	const VncServerClientList previousClients = m_clients;
-	m_clients.clear();
 
-	for( auto prevClient : qAsConst( previousClients ) )
+	for( auto prevClient : previousClients )
 	{
 		prevClient->setAccessControlState( VncServerClient::AccessControlState::Init );
 		addClient( prevClient );
-
-		if( prevClient->accessControlState() != VncServerClient::AccessControlState::Successful &&
-			prevClient->accessControlState() != VncServerClient::AccessControlState::Pending )
-		{
-			vDebug() << "closing connection as client does not pass access control any longer";
-			prevClient->setProtocolState( VncServerProtocol::Close );
-		}
 	}
 }
 
@@ -97,6 +111,13 @@ void ServerAccessControlManager::removeClient( VncServerClient* client )
 
 void ServerAccessControlManager::performAccessControl( VncServerClient* client )
 {
+	// still waiting for result of a previous request?
+	if( isAccessControlPending( client ) )
+	{
+		client->setAccessControlState( VncServerClient::AccessControlState::Waiting );
+		return;
+	}
+
 	// implement access control wait for connections other than the one an
 	// access dialog is currently active for
 	switch( client->accessControlState() )
@@ -115,12 +136,66 @@ void ServerAccessControlManager::performAccessControl( VncServerClient* client )
 		break;
 	}
 
-	const auto accessResult =
-			AccessControlProvider().checkAccess( client->username(),
-												 client->hostAddress(),
-												 connectedUsers() );
+	const auto username = client->username();
+	const auto hostAddress = client->hostAddress();
+
+	auto users = connectedUsers( client );
+	std::sort( users.begin(), users.end() );
+
+	const auto request = AccessControlRequest( { username, hostAddress } ) + users;
+
+	// keep client waiting until the result is available
+	client->setAccessControlState( VncServerClient::AccessControlState::Waiting );
+
+	// identical request already being evaluated?
+	const auto pendingAccessControl = m_pendingAccessControls.find( request );
+	if( pendingAccessControl != m_pendingAccessControls.end() )
+	{
+		pendingAccessControl->clients.append( client );
+		return;
+	}
+
+	auto watcher = new QFutureWatcher<AccessControlProvider::Access>( this );
+	connect( watcher, &QFutureWatcherBase::finished, this, [=]() { finishAccessControl( request ); } );
+
+	m_pendingAccessControls[request] = { watcher, { client } };
+
+	watcher->setFuture( QtConcurrent::run( &m_accessControlThreadPool, [=]() {
+		return m_accessControlProvider.checkAccess( username, hostAddress, users );
+	} ) );
+}
+
+
+
+void ServerAccessControlManager::finishAccessControl( const AccessControlRequest& request )
+{
+	const auto pendingAccessControl = m_pendingAccessControls.take( request );
+	if( pendingAccessControl.watcher == nullptr )
+	{
+		return;
+	}
+
+	const auto access = pendingAccessControl.watcher->result();
+
+	pendingAccessControl.watcher->deleteLater();
+
+	for( const auto& client : pendingAccessControl.clients )
+	{
+		// client might have disconnected in the meantime
+		if( client )
+		{
+			applyAccessControlResult( client, access );
+		}
+	}
+}
+
 
-	switch( accessResult )
+
+void ServerAccessControlManager::applyAccessControlResult( VncServerClient* client, AccessControlProvider::Access access )
+{
+	const auto wasConnected = m_clients.contains( client );
+
+	switch( access )
 	{
 	case AccessControlProvider::Access::Allow:
 		client->setAccessControlState( VncServerClient::AccessControlState::Successful );
@@ -132,15 +207,50 @@ void ServerAccessControlManager::performAccessControl( VncServerClient* client )
 
 	default:
 		client->setAccessControlState( VncServerClient::AccessControlState::Failed );
-		client->setProtocolState( VncServerProtocol::Close );
 		break;
 	}
 
+	const auto state = client->accessControlState();
+
+	if( state == VncServerClient::AccessControlState::Successful )
+	{
+		if( wasConnected == false )
+		{
+			m_clients.append( client );
+		}
+	}
+	else if( state == VncServerClient::AccessControlState::Failed ||
+			 ( wasConnected && state != VncServerClient::AccessControlState::Pending ) )
+	{
+		if( wasConnected )
+		{
+			vDebug() << "closing connection as client does not pass access control any longer";
+			m_clients.removeAll( client );
+		}
+
+		client->setProtocolState( VncServerProtocol::Close );
+	}
+
 	emit finished( client );
 }
 
 
 
+bool ServerAccessControlManager::isAccessControlPending( VncServerClient* client ) const
+{
+	for( const auto& pendingAccessControl : m_pendingAccessControls )
+	{
+		if( pendingAccessControl.clients.contains( client ) )
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+
 VncServerClient::AccessControlState ServerAccessControlManager::confirmDesktopAccess( VncServerClient* client )
 {
 	const HostUserPair hostUserPair( client->username(), client->hostAddress() );
@@ -203,18 +313,22 @@ void ServerAccessControlManager::finishDesktopAccessConfirmation( VncServerClien
 	if( choice == DesktopAccessDialog::ChoiceYes || choice == DesktopAccessDialog::ChoiceAlways )
 	{
 		client->setAccessControlState( VncServerClient::AccessControlState::Successful );
-		m_clients.append( client );
+		if( m_clients.contains( client ) == false )
+		{
+			m_clients.append( client );
+		}
 	}
 	else
 	{
 		client->setAccessControlState( VncServerClient::AccessControlState::Failed );
 		client->setProtocolState( VncServerProtocol::Close );
+		m_clients.removeAll( client );
 	}
 }
 
 
 
-QStringList ServerAccessControlManager::connectedUsers() const
+QStringList ServerAccessControlManager::connectedUsers( const VncServerClient* excludedClient ) const
 {
 	QStringList users;
 
@@ -222,7 +336,10 @@ QStringList ServerAccessControlManager::connectedUsers() const
 
 	for( auto client : m_clients )
 	{
-		users += client->username();
+		if( client != excludedClient )
+		{
+			users += client->username();
+		}
 	}
 
 	return users;
@@ -24,6 +24,11 @@
 
 #pragma once
 
+#include <QFutureWatcher>
+#include <QPointer>
+#include <QThreadPool>
+
+#include "AccessControlProvider.h"
 #include "DesktopAccessDialog.h"
 #include "VncServerClient.h"
 
@@ -47,15 +52,34 @@ signals:
 private:
 	static constexpr int ClientWaitInterval = 1000;
 
+	// accessing user, accessing computer and sorted list of connected users
+	using AccessControlRequest = QStringList;
+
+	struct PendingAccessControl
+	{
+		QFutureWatcher<AccessControlProvider::Access>* watcher;
+		QList<QPointer<VncServerClient>> clients;
+	};
+
 	void performAccessControl( VncServerClient* client );
+	void finishAccessControl( const AccessControlRequest& request );
+	void applyAccessControlResult( VncServerClient* client, AccessControlProvider::Access access );
+	bool isAccessControlPending( VncServerClient* client ) const;
+
 	VncServerClient::AccessControlState confirmDesktopAccess( VncServerClient* client );
 	void finishDesktopAccessConfirmation( VncServerClient* client );
 
-	QStringList connectedUsers() const;
+	QStringList connectedUsers( const VncServerClient* excludedClient ) const;
 
 	FeatureWorkerManager& m_featureWorkerManager;
 	DesktopAccessDialog& m_desktopAccessDialog;
 
+	AccessControlProvider m_accessControlProvider;
+
+	// declared after m_accessControlProvider so running evaluations finish before it is destroyed
+	QThreadPool m_accessControlThreadPool;
+	QHash<AccessControlRequest, PendingAccessControl> m_pendingAccessControls;
+
 	VncServerClientList m_clients;
 
 	using HostUserPair = QPair<QString, QString>;
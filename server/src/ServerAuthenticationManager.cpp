@@ -22,13 +22,24 @@
  *
  */
 
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QMessageAuthenticationCode>
+
 #include "AuthenticationManager.h"
 #include "ServerAuthenticationManager.h"
+#include "VariantArrayMessage.h"
 #include "VeyonConfiguration.h"
 
 
 ServerAuthenticationManager::ServerAuthenticationManager( QObject* parent ) :
-	QObject( parent )
+	QObject( parent ),
+	m_sessionTicketKey( CryptoCore::generateChallenge() ),
+	m_pendingSessionTickets(),
+	m_activeSessionTickets(),
+	m_authenticationFailures(),
+	m_failureStatistics()
 {
 }
 
@@ -42,7 +53,11 @@ void ServerAuthenticationManager::processAuthenticationMessage( VncServerClient*
 			 << "host" << client->hostAddress()
 			 << "user" << client->username();
 
-	if( client->authPluginUid() == VeyonCore::config().authenticationPlugin()  )
+	if( client->authPluginUid() == AuthenticationManager::sessionTicketUid() )
+	{
+		client->setAuthState( verifySessionTicket( client, message ) );
+	}
+	else if( client->authPluginUid() == VeyonCore::config().authenticationPlugin()  )
 	{
 		client->setAuthState( VeyonCore::authenticationManager().configuredPlugin()->performAuthentication( client, message ) );
 	}
@@ -55,9 +70,333 @@ void ServerAuthenticationManager::processAuthenticationMessage( VncServerClient*
 	{
 	case VncServerClient::AuthState::Failed:
 	case VncServerClient::AuthState::Successful:
+		updateAuthenticationFailures( client );
 		emit finished( client );
 		break;
 	default:
 		break;
 	}
 }
+
+
+
+/*!
+ * \brief Creates a ticket which allows the given client to resume its session without authentication and
+ * access control. The ticket is bound to user, host and configuration and only accepted once and after
+ * updateSessionTicket() has been called for the client. Along with the ticket the client receives the public
+ * key of an ephemeral X25519 key pair. Client and server both derive the secret which the client has to prove
+ * possession of when using the ticket from the resulting shared secret so the secret is never transmitted.
+ */
+VncServerProtocol::SessionTicket ServerAuthenticationManager::issueSessionTicket( VncServerClient* client )
+{
+	const auto now = QDateTime::currentMSecsSinceEpoch();
+	const auto resumedSession = client->authPluginUid() == AuthenticationManager::sessionTicketUid();
+
+	// tickets are used only once so resumed sessions get a new ticket which however
+	// must not extend the session beyond the expiry of the initial ticket
+	const auto expiry = resumedSession ? client->sessionTicketExpiry() : now + AuthenticationManager::SessionTicketLifetime;
+	if( expiry <= now )
+	{
+		return {};
+	}
+
+	const auto privateKey = CryptoCore::createX25519PrivateKey();
+	const auto sharedSecret = CryptoCore::deriveX25519SharedSecret( privateKey, client->sessionTicketPublicKey() );
+	if( sharedSecret.isEmpty() )
+	{
+		vWarning() << "could not agree on session ticket secret with" << client->hostAddress();
+		return {};
+	}
+
+	const auto ticketId = CryptoCore::generateChallenge().left( SessionTicketIdSize );
+
+	QByteArray ticketData;
+	QDataStream stream( &ticketData, QIODevice::WriteOnly );
+	stream << SessionTicketVersion << ticketId << client->username() << client->hostAddress()
+		   << configurationHash() << expiry;
+
+	const auto ticket = ticketData + sessionTicketMac( ticketData );
+	const SessionTicketState ticketState{ expiry,
+										  AuthenticationManager::sessionTicketSecret( sharedSecret.toByteArray(), ticket ) };
+
+	client->setSessionTicketId( ticketId );
+	client->setSessionTicketExpiry( expiry );
+
+	// client passed access control when its previous ticket has been activated
+	if( resumedSession )
+	{
+		m_activeSessionTickets[ticketId] = ticketState;
+	}
+	else
+	{
+		m_pendingSessionTickets[ticketId] = ticketState;
+	}
+
+	return { ticket, CryptoCore::x25519PublicKey( privateKey ) };
+}
+
+
+
+/*!
+ * \brief Activates the session ticket of the given client once it passed access control and revokes it
+ * if the client does not pass access control (any longer)
+ */
+void ServerAuthenticationManager::updateSessionTicket( VncServerClient* client )
+{
+	if( client->sessionTicketId().isEmpty() )
+	{
+		return;
+	}
+
+	switch( client->accessControlState() )
+	{
+	case VncServerClient::AccessControlState::Successful:
+		break;
+	case VncServerClient::AccessControlState::Pending:
+		return;
+	default:
+		m_pendingSessionTickets.remove( client->sessionTicketId() );
+		m_activeSessionTickets.remove( client->sessionTicketId() );
+		return;
+	}
+
+	const auto now = QDateTime::currentMSecsSinceEpoch();
+
+	removeExpiredSessionTickets( m_pendingSessionTickets, now );
+	removeExpiredSessionTickets( m_activeSessionTickets, now );
+
+	// activate tickets only once as they must not become valid again after they have been used
+	const auto ticketState = m_pendingSessionTickets.take( client->sessionTicketId() );
+	if( ticketState.expiry > now )
+	{
+		m_activeSessionTickets[client->sessionTicketId()] = ticketState;
+	}
+}
+
+
+
+void ServerAuthenticationManager::removeExpiredSessionTickets( SessionTickets& sessionTickets, qint64 now )
+{
+	for( auto it = sessionTickets.begin(); it != sessionTickets.end(); )
+	{
+		if( it.value().expiry < now )
+		{
+			it = sessionTickets.erase( it );
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
+
+
+/*!
+ * \brief Returns whether a new connection from the given host should be accepted. Hosts which repeatedly
+ * failed to authenticate are refused with an exponentially growing backoff so they can't make the server
+ * generate challenges and query authentication backends at an arbitrary rate.
+ */
+bool ServerAuthenticationManager::admitConnection( const QString& hostAddress )
+{
+	const auto it = m_authenticationFailures.find( hostAddress );
+	if( it == m_authenticationFailures.end() )
+	{
+		return true;
+	}
+
+	const auto now = QDateTime::currentMSecsSinceEpoch();
+
+	if( it->lastFailure + FailureMemoryTime < now )
+	{
+		m_authenticationFailures.erase( it );
+		return true;
+	}
+
+	if( now < it->blockedUntil )
+	{
+		++m_failureStatistics.refusedConnections;
+		return false;
+	}
+
+	return true;
+}
+
+
+
+void ServerAuthenticationManager::updateAuthenticationFailures( VncServerClient* client )
+{
+	if( client->authState() == VncServerClient::AuthState::Successful )
+	{
+		m_authenticationFailures.remove( client->hostAddress() );
+		return;
+	}
+
+	// outdated session tickets are followed by a regular authentication and thus do not count
+	if( client->authPluginUid() == AuthenticationManager::sessionTicketUid() )
+	{
+		return;
+	}
+
+	++m_failureStatistics.failedAuthentications;
+
+	const auto now = QDateTime::currentMSecsSinceEpoch();
+
+	if( m_authenticationFailures.size() >= MaximumFailureEntries )
+	{
+		for( auto it = m_authenticationFailures.begin(); it != m_authenticationFailures.end(); )
+		{
+			if( it->lastFailure + FailureMemoryTime < now )
+			{
+				it = m_authenticationFailures.erase( it );
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+
+	auto& failures = m_authenticationFailures[client->hostAddress()];
+	if( failures.lastFailure + FailureMemoryTime < now )
+	{
+		failures = { 0, 0, 0 };
+	}
+
+	++failures.count;
+	failures.lastFailure = now;
+
+	if( failures.count >= FailureBackoffThreshold )
+	{
+		const auto shift = qMin<int>( failures.count - FailureBackoffThreshold, FailureBackoffMaximumShift );
+		const auto backoff = qMin<int>( MinimumFailureBackoff << shift, MaximumFailureBackoff );
+
+		failures.blockedUntil = now + backoff;
+
+		vWarning() << "refusing connections from" << client->hostAddress() << "for" << backoff << "ms after"
+				   << failures.count << "failed authentication attempts (failed:"
+				   << m_failureStatistics.failedAuthentications
+				   << "refused:" << m_failureStatistics.refusedConnections << ")";
+	}
+}
+
+
+
+VncServerClient::AuthState ServerAuthenticationManager::verifySessionTicket( VncServerClient* client,
+																			   VariantArrayMessage& message )
+{
+	if( client->authState() == VncServerClient::AuthState::Init )
+	{
+		// send challenge which the client has to authenticate with the ticket secret
+		client->setChallenge( CryptoCore::generateChallenge() );
+		if( VariantArrayMessage( message.ioDevice() ).write( client->challenge() ).send() == false )
+		{
+			vWarning() << "failed to send challenge";
+			return VncServerClient::AuthState::Failed;
+		}
+
+		// wait for ticket
+		return VncServerClient::AuthState::Stage1;
+	}
+
+	const auto ticket = message.read().toByteArray(); // Flawfinder: ignore
+	const auto proof = message.read().toByteArray(); // Flawfinder: ignore
+	const auto macSize = QCryptographicHash::hashLength( QCryptographicHash::Sha256 );
+
+	if( ticket.size() <= macSize )
+	{
+		vWarning() << "invalid session ticket";
+		return VncServerClient::AuthState::Failed;
+	}
+
+	const auto ticketData = ticket.left( ticket.size() - macSize );
+	const auto mac = ticket.right( macSize );
+	const auto expectedMac = sessionTicketMac( ticketData );
+
+	if( isEqualMac( mac, expectedMac ) == false )
+	{
+		vWarning() << "session ticket with invalid MAC (server restarted?)";
+		return VncServerClient::AuthState::Failed;
+	}
+
+	quint8 version = 0;
+	QByteArray ticketId;
+	QString username;
+	QString hostAddress;
+	QByteArray configHash;
+	qint64 expiry = 0;
+
+	QDataStream stream( ticketData );
+	stream >> version >> ticketId >> username >> hostAddress >> configHash >> expiry;
+
+	const auto now = QDateTime::currentMSecsSinceEpoch();
+
+	// invalidate ticket so it can't be replayed
+	const auto ticketState = m_activeSessionTickets.take( ticketId );
+
+	if( stream.status() != QDataStream::Ok || version != SessionTicketVersion ||
+		username != client->username() ||
+		hostAddress != client->hostAddress() ||
+		expiry < now ||
+		ticketState.expiry < now )
+	{
+		vWarning() << "session ticket expired or not valid for" << client->username() << client->hostAddress();
+		return VncServerClient::AuthState::Failed;
+	}
+
+	if( configHash != configurationHash() )
+	{
+		vWarning() << "session ticket issued for different configuration";
+		return VncServerClient::AuthState::Failed;
+	}
+
+	const auto expectedProof = QMessageAuthenticationCode::hash( client->challenge(), ticketState.secret,
+																 QCryptographicHash::Sha256 );
+	if( isEqualMac( proof, expectedProof ) == false )
+	{
+		vWarning() << "session ticket used without proof of possession by" << client->username() << client->hostAddress();
+		return VncServerClient::AuthState::Failed;
+	}
+
+	client->setSessionTicketId( ticketId );
+	client->setSessionTicketExpiry( expiry );
+
+	return VncServerClient::AuthState::Successful;
+}
+
+
+
+QByteArray ServerAuthenticationManager::sessionTicketMac( const QByteArray& ticketData ) const
+{
+	return QMessageAuthenticationCode::hash( ticketData, m_sessionTicketKey, QCryptographicHash::Sha256 );
+}
+
+
+
+bool ServerAuthenticationManager::isEqualMac( const QByteArray& mac, const QByteArray& expectedMac )
+{
+	if( mac.size() != expectedMac.size() )
+	{
+		return false;
+	}
+
+	// compare in constant time
+	char difference = 0;
+	for( int i = 0; i < mac.size(); ++i )
+	{
+		difference |= char( mac[i] ^ expectedMac[i] );
+	}
+
+	return difference == 0;
+}
+
+
+
+QByteArray ServerAuthenticationManager::configurationHash()
+{
+	QByteArray configurationData;
+	QDataStream stream( &configurationData, QIODevice::WriteOnly );
+	stream << VeyonCore::config().data();
+
+	return QCryptographicHash::hash( configurationData, QCryptographicHash::Sha256 );
+}
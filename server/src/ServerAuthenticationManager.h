@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include <QHash>
 #include <QMutex>
 #include <QStringList>
 
@@ -41,13 +42,76 @@ public:
 	} ;
 	Q_ENUM(AuthResult)
 
+	struct FailureStatistics
+	{
+		quint64 failedAuthentications{0};
+		quint64 refusedConnections{0};
+	};
+
 	explicit ServerAuthenticationManager( QObject* parent );
 
 	void processAuthenticationMessage( VncServerClient* client,
 									   VariantArrayMessage& message );
 
+	VncServerProtocol::SessionTicket issueSessionTicket( VncServerClient* client );
+	void updateSessionTicket( VncServerClient* client );
+
+	bool admitConnection( const QString& hostAddress );
+
+	const FailureStatistics& failureStatistics() const
+	{
+		return m_failureStatistics;
+	}
 
 signals:
 	void finished( VncServerClient* client );
 
+private:
+	static constexpr int SessionTicketIdSize = 16;
+	static constexpr quint8 SessionTicketVersion = 1;
+
+	static constexpr int FailureBackoffThreshold = 5;
+	static constexpr int MinimumFailureBackoff = 1000;
+	static constexpr int MaximumFailureBackoff = 60*1000;
+	static constexpr int FailureBackoffMaximumShift = 6;
+	static constexpr int FailureMemoryTime = 10*60*1000;
+	static constexpr int MaximumFailureEntries = 1024;
+
+	struct AuthenticationFailures
+	{
+		int count;
+		qint64 lastFailure;
+		qint64 blockedUntil;
+	};
+
+	struct SessionTicketState
+	{
+		qint64 expiry{0};
+		QByteArray secret;
+	};
+
+	// states of tickets indexed by ticket ID
+	using SessionTickets = QHash<QByteArray, SessionTicketState>;
+
+	void updateAuthenticationFailures( VncServerClient* client );
+
+	VncServerClient::AuthState verifySessionTicket( VncServerClient* client, VariantArrayMessage& message );
+	QByteArray sessionTicketMac( const QByteArray& ticketData ) const;
+	static bool isEqualMac( const QByteArray& mac, const QByteArray& expectedMac );
+	static void removeExpiredSessionTickets( SessionTickets& sessionTickets, qint64 now );
+	static QByteArray configurationHash();
+
+	// random key generated at startup, i.e. tickets are invalidated when the server restarts
+	const QByteArray m_sessionTicketKey;
+
+	// IDs of tickets issued to clients which did not pass access control yet
+	SessionTickets m_pendingSessionTickets;
+
+	// IDs of unused tickets issued to clients which passed access control
+	SessionTickets m_activeSessionTickets;
+
+	// hosts with recent authentication failures which have to wait before connecting again
+	QHash<QString, AuthenticationFailures> m_authenticationFailures;
+	FailureStatistics m_failureStatistics;
+
 } ;
@@ -22,6 +22,7 @@
  *
  */
 
+#include "AuthenticationManager.h"
 #include "ServerAuthenticationManager.h"
 #include "ServerAccessControlManager.h"
 #include "VeyonServerProtocol.h"
@@ -42,7 +43,14 @@ VeyonServerProtocol::VeyonServerProtocol( QTcpSocket* socket,
 
 VeyonServerProtocol::AuthPluginUids VeyonServerProtocol::supportedAuthPluginUids() const
 {
-	return { VeyonCore::config().authenticationPlugin() };
+	return { VeyonCore::config().authenticationPlugin(), AuthenticationManager::sessionTicketUid() };
+}
+
+
+
+VeyonServerProtocol::SessionTicket VeyonServerProtocol::issueSessionTicket()
+{
+	return m_serverAuthenticationManager.issueSessionTicket( client() );
 }
 
 
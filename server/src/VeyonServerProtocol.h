@@ -43,6 +43,7 @@ protected:
 	AuthPluginUids supportedAuthPluginUids() const override;
 	void processAuthenticationMessage( VariantArrayMessage& message ) override;
 	void performAccessControl() override;
+	SessionTicket issueSessionTicket() override;
 
 private:
 	ServerAuthenticationManager& m_serverAuthenticationManager;
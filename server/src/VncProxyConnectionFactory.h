@@ -26,6 +26,7 @@
 
 #include "CryptoCore.h"
 
+class QHostAddress;
 class QTcpSocket;
 class VncProxyConnection;
 
@@ -43,4 +44,11 @@ public:
 														  const Password& vncServerPassword,
 														  QObject* parent ) = 0;
 
+	// allows refusing connections before any protocol handling takes place
+	virtual bool isConnectionAllowed( const QHostAddress& peerAddress )
+	{
+		Q_UNUSED(peerAddress)
+		return true;
+	}
+
 } ;
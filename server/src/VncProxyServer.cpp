@@ -41,8 +41,14 @@ VncProxyServer::VncProxyServer( const QHostAddress& listenAddress,
 	m_listenAddress( listenAddress ),
 	m_listenPort( listenPort ),
 	m_server( new QTcpServer( this ) ),
-	m_connectionFactory( connectionFactory )
+	m_connectionFactory( connectionFactory ),
+	m_connections(),
+	m_connectionRateTimer(),
+	m_connectionBuckets(),
+	m_connectionStatistics()
 {
+	m_connectionRateTimer.start();
+
 	connect( m_server, &QTcpServer::newConnection, this, &VncProxyServer::acceptConnection );
 }
 
@@ -89,8 +95,38 @@ void VncProxyServer::stop()
 
 void VncProxyServer::acceptConnection()
 {
+	auto clientSocket = m_server->nextPendingConnection();
+	if( clientSocket == nullptr )
+	{
+		return;
+	}
+
+	// refuse connection floods before any protocol, crypto or directory work is done for them
+	const auto peerAddress = clientSocket->peerAddress();
+
+	if( takeConnectionToken( peerAddress ) == false )
+	{
+		++m_connectionStatistics.rateLimited;
+		clientSocket->abort();
+		clientSocket->deleteLater();
+		return;
+	}
+
+	if( m_connectionFactory->isConnectionAllowed( peerAddress ) == false )
+	{
+		++m_connectionStatistics.refused;
+		vDebug() << "refusing connection from" << peerAddress.toString()
+				 << "accepted:" << m_connectionStatistics.accepted
+				 << "refused:" << m_connectionStatistics.refused;
+		clientSocket->abort();
+		clientSocket->deleteLater();
+		return;
+	}
+
+	++m_connectionStatistics.accepted;
+
 	VncProxyConnection* connection =
-			m_connectionFactory->createVncProxyConnection( m_server->nextPendingConnection(),
+			m_connectionFactory->createVncProxyConnection( clientSocket,
 														   m_vncServerPort,
 														   m_vncServerPassword,
 														   this );
@@ -109,3 +145,72 @@ void VncProxyServer::closeConnection( VncProxyConnection* connection )
 
 	connection->deleteLater();
 }
+
+
+
+/*!
+ * \brief Implements a token bucket per peer address which allows short bursts of connections
+ * (e.g. a master opening all its connections at once) but limits the sustained connection rate.
+ */
+bool VncProxyServer::takeConnectionToken( const QHostAddress& peerAddress )
+{
+	const auto now = m_connectionRateTimer.elapsed();
+
+	if( m_connectionBuckets.size() >= MaximumConnectionBuckets )
+	{
+		// forget about peers whose buckets have been refilled completely
+		for( auto it = m_connectionBuckets.begin(); it != m_connectionBuckets.end(); )
+		{
+			refillConnectionBucket( it.value(), now );
+			if( it->tokens >= ConnectionBurstSize )
+			{
+				it = m_connectionBuckets.erase( it );
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+
+	auto it = m_connectionBuckets.find( peerAddress );
+	if( it == m_connectionBuckets.end() )
+	{
+		it = m_connectionBuckets.insert( peerAddress, { ConnectionBurstSize, now, false } );
+	}
+
+	auto& bucket = it.value();
+	refillConnectionBucket( bucket, now );
+
+	if( bucket.tokens < 1 )
+	{
+		if( bucket.throttled == false )
+		{
+			vWarning() << "too many connections from" << peerAddress.toString()
+					   << "- throttling (accepted:" << m_connectionStatistics.accepted
+					   << "rate limited:" << m_connectionStatistics.rateLimited << ")";
+			bucket.throttled = true;
+		}
+		return false;
+	}
+
+	if( bucket.throttled )
+	{
+		vInfo() << "no longer throttling connections from" << peerAddress.toString()
+				<< "(rate limited:" << m_connectionStatistics.rateLimited << ")";
+		bucket.throttled = false;
+	}
+
+	bucket.tokens -= 1;
+
+	return true;
+}
+
+
+
+void VncProxyServer::refillConnectionBucket( ConnectionBucket& bucket, qint64 now )
+{
+	bucket.tokens = qMin<double>( ConnectionBurstSize,
+								  bucket.tokens + ( now - bucket.lastRefill ) * ConnectionsPerSecond / 1000.0 );
+	bucket.lastRefill = now;
+}
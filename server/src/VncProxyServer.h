@@ -24,6 +24,8 @@
 
 #pragma once
 
+#include <QElapsedTimer>
+#include <QHash>
 #include <QHostAddress>
 #include <QVector>
 
@@ -40,6 +42,13 @@ public:
 	using Password = CryptoCore::PlaintextPassword;
 	using VncProxyConnectionList = QVector<VncProxyConnection *>;
 
+	struct ConnectionStatistics
+	{
+		quint64 accepted{0};
+		quint64 rateLimited{0};
+		quint64 refused{0};
+	};
+
 	VncProxyServer( const QHostAddress& listenAddress,
 					int listenPort,
 					VncProxyConnectionFactory* clientFactory,
@@ -54,10 +63,29 @@ public:
 		return m_connections;
 	}
 
+	const ConnectionStatistics& connectionStatistics() const
+	{
+		return m_connectionStatistics;
+	}
+
 private:
+	static constexpr int ConnectionBurstSize = 20;
+	static constexpr int ConnectionsPerSecond = 5;
+	static constexpr int MaximumConnectionBuckets = 1024;
+
+	struct ConnectionBucket
+	{
+		double tokens;
+		qint64 lastRefill;
+		bool throttled;
+	};
+
 	void acceptConnection();
 	void closeConnection( VncProxyConnection* );
 
+	bool takeConnectionToken( const QHostAddress& peerAddress );
+	static void refillConnectionBucket( ConnectionBucket& bucket, qint64 now );
+
 	int m_vncServerPort;
 	Password m_vncServerPassword;
 	QHostAddress m_listenAddress;
@@ -66,4 +94,8 @@ private:
 	VncProxyConnectionFactory* m_connectionFactory;
 	VncProxyConnectionList m_connections;
 
+	QElapsedTimer m_connectionRateTimer;
+	QHash<QHostAddress, ConnectionBucket> m_connectionBuckets;
+	ConnectionStatistics m_connectionStatistics;
+
 } ;
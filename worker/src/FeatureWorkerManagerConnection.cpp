@@ -33,24 +33,30 @@
 FeatureWorkerManagerConnection::FeatureWorkerManagerConnection( VeyonWorkerInterface& worker,
 																FeatureManager& featureManager,
 																Feature::Uid featureUid,
+																int standbyWorkerProcessMode,
 																QObject* parent ) :
 	QObject( parent ),
 	m_worker( worker ),
 	m_featureManager( featureManager ),
 	m_socket( this ),
-	m_featureUid( featureUid )
+	m_featureUid( featureUid ),
+	m_standbyWorkerProcessMode( standbyWorkerProcessMode )
 {
-	connect( &m_socket, &QTcpSocket::connected,
+	connect( &m_socket, &FeatureWorkerManager::Socket::connected,
 			 this, &FeatureWorkerManagerConnection::sendInitMessage );
 
-	connect( &m_socket, &QTcpSocket::disconnected,
+	connect( &m_socket, &FeatureWorkerManager::Socket::disconnected,
 			 QCoreApplication::instance(), &QCoreApplication::quit );
 
-	connect( &m_socket, &QTcpSocket::readyRead,
+	connect( &m_socket, &FeatureWorkerManager::Socket::readyRead,
 			 this, &FeatureWorkerManagerConnection::receiveMessage );
 
+#ifdef Q_OS_LINUX
+	m_socket.connectToServer( FeatureWorkerManager::serverName() );
+#else
 	m_socket.connectToHost( QHostAddress::LocalHost,
 							static_cast<quint16>( VeyonCore::config().featureWorkerManagerPort() + VeyonCore::sessionId() ) );
+#endif
 }
 
 
@@ -66,7 +72,25 @@ void FeatureWorkerManagerConnection::sendInitMessage()
 {
 	vDebug() << m_featureUid;
 
-	FeatureMessage( m_featureUid, FeatureMessage::InitCommand ).send( &m_socket );
+#ifdef Q_OS_LINUX
+	// do not talk to processes which took over the name of the server's socket
+	if( FeatureWorkerManager::isAuthorizedServer( &m_socket ) == false )
+	{
+		vCritical() << "rejecting connection to unauthorized server";
+		m_socket.abort();
+		QCoreApplication::quit();
+		return;
+	}
+#endif
+
+	FeatureMessage initMessage( m_featureUid, FeatureMessage::InitCommand );
+
+	if( m_featureUid.isNull() )
+	{
+		initMessage.addArgument( FeatureWorkerManager::InitArgument::WorkerProcessMode, m_standbyWorkerProcessMode );
+	}
+
+	initMessage.send( &m_socket );
 }
 
 
@@ -77,7 +101,21 @@ void FeatureWorkerManagerConnection::receiveMessage()
 
 	while( featureMessage.isReadyForReceive( &m_socket ) )
 	{
-		if( featureMessage.receive( &m_socket ) )
+		if( featureMessage.receive( &m_socket ) == false )
+		{
+			continue;
+		}
+
+		if( m_featureUid.isNull() )
+		{
+			// standby worker gets assigned a feature via init command
+			if( featureMessage.command() == FeatureMessage::InitCommand )
+			{
+				m_featureUid = featureMessage.featureUid();
+				Q_EMIT featureAssigned( m_featureUid );
+			}
+		}
+		else
 		{
 			m_featureManager.handleFeatureMessage( m_worker, featureMessage );
 		}
@@ -24,9 +24,8 @@
 
 #pragma once
 
-#include <QTcpSocket>
-
 #include "Feature.h"
+#include "FeatureWorkerManager.h"
 
 class FeatureManager;
 class FeatureMessage;
@@ -39,18 +38,23 @@ public:
 	FeatureWorkerManagerConnection( VeyonWorkerInterface& worker,
 									FeatureManager& featureManager,
 									Feature::Uid featureUid,
+									int standbyWorkerProcessMode,
 									QObject* parent = nullptr );
 
 
 	bool sendMessage( const FeatureMessage& message );
 
+Q_SIGNALS:
+	void featureAssigned( Feature::Uid featureUid );
+
 private:
 	void sendInitMessage();
 	void receiveMessage();
 
 	VeyonWorkerInterface& m_worker;
 	FeatureManager& m_featureManager;
-	QTcpSocket m_socket;
+	FeatureWorkerManager::Socket m_socket;
 	Feature::Uid m_featureUid;
+	int m_standbyWorkerProcessMode;
 
 } ;
@@ -29,13 +29,45 @@
 #include "VeyonWorker.h"
 
 
-VeyonWorker::VeyonWorker( const QString& featureUid, QObject* parent ) :
+VeyonWorker::VeyonWorker( const QString& featureUid, int standbyWorkerProcessMode, QObject* parent ) :
 	QObject( parent ),
 	m_core( QCoreApplication::instance(),
 			VeyonCore::Component::Worker,
-			QStringLiteral( "FeatureWorker-" ) + VeyonCore::formattedUuid( featureUid ) ),
+			featureUid.isEmpty() ? QStringLiteral( "FeatureWorker-Standby" )
+								 : QStringLiteral( "FeatureWorker-" ) + VeyonCore::formattedUuid( featureUid ),
+			featureUid.isEmpty() ? QStringList() : QStringList( featureUid ) ),
 	m_featureManager(),
 	m_workerManagerConnection( nullptr )
+{
+	if( featureUid.isEmpty() )
+	{
+		// wait for the feature worker manager to assign a feature
+		m_workerManagerConnection = new FeatureWorkerManagerConnection( *this, m_featureManager, {},
+																		standbyWorkerProcessMode, this );
+		connect( m_workerManagerConnection, &FeatureWorkerManagerConnection::featureAssigned,
+				 this, &VeyonWorker::initFeature );
+
+		vInfo() << "Running standby worker";
+	}
+	else
+	{
+		initFeature( Feature::Uid( featureUid ) );
+
+		m_workerManagerConnection = new FeatureWorkerManagerConnection( *this, m_featureManager, featureUid,
+																		standbyWorkerProcessMode, this );
+	}
+}
+
+
+
+bool VeyonWorker::sendFeatureMessageReply( const FeatureMessage& reply )
+{
+	return m_workerManagerConnection->sendMessage( reply );
+}
+
+
+
+void VeyonWorker::initFeature( Feature::Uid featureUid )
 {
 	const Feature* workerFeature = nullptr;
 
@@ -52,19 +84,10 @@ VeyonWorker::VeyonWorker( const QString& featureUid, QObject* parent ) :
 		qFatal( "Could not find specified feature" );
 	}
 
-	if( m_core.config().disabledFeatures().contains( featureUid ) )
+	if( m_core.config().disabledFeatures().contains( featureUid.toString() ) )
 	{
 		qFatal( "Specified feature is disabled by configuration!" );
 	}
 
-	m_workerManagerConnection = new FeatureWorkerManagerConnection( *this, m_featureManager, featureUid, this );
-
 	vInfo() << "Running worker for feature" << workerFeature->name();
 }
-
-
-
-bool VeyonWorker::sendFeatureMessageReply( const FeatureMessage& reply )
-{
-	return m_workerManagerConnection->sendMessage( reply );
-}
@@ -33,7 +33,7 @@ class VeyonWorker : public QObject, VeyonWorkerInterface
 {
 	Q_OBJECT
 public:
-	explicit VeyonWorker( const QString& featureUid, QObject* parent = nullptr );
+	explicit VeyonWorker( const QString& featureUid, int standbyWorkerProcessMode = -1, QObject* parent = nullptr );
 
 	bool sendFeatureMessageReply( const FeatureMessage& reply ) override;
 
@@ -43,6 +43,8 @@ public:
 	}
 
 private:
+	void initFeature( Feature::Uid featureUid );
+
 	VeyonCore m_core;
 	FeatureManager m_featureManager;
 	FeatureWorkerManagerConnection* m_workerManagerConnection;
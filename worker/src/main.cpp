@@ -24,6 +24,7 @@
 
 #include <QApplication>
 
+#include "FeatureWorkerManager.h"
 #include "VeyonWorker.h"
 
 
@@ -39,6 +40,18 @@ int main( int argc, char **argv )
 		qFatal( "Not enough arguments (feature)" );
 	}
 
+	if( arguments[1] == FeatureWorkerManager::standbyWorkerArgument() )
+	{
+		if( arguments.count() < 3 )
+		{
+			qFatal( "Not enough arguments (worker process mode)" );
+		}
+
+		VeyonWorker worker( {}, arguments[2].toInt() );
+
+		return worker.core().exec();
+	}
+
 	const auto featureUid = arguments[1];
 	if( QUuid( featureUid ).isNull() )
 	{